@@ -0,0 +1,23 @@
+#ifndef BENCHMARK_GRAPH_H // !BENCHMARK_GRAPH_H
+#define BENCHMARK_GRAPH_H
+
+#include <modules/ImGuiNodes.h>
+#include <modules/ImGuiNodesSnapshot.h>
+
+// Deterministic synthetic graph shared by the benchmark and input recordings, a recording only
+// replays frame-exact against the same graph, display size and font it was captured with
+namespace BenchmarkGraph
+{
+    void RegisterNodeDesc(ImGui::ImGuiNodes &nodes);
+
+    // Square grid, every node feeds its right and bottom neighbours, built by the next ImGuiNodes::Update()
+    void MakeGraph(ImGui::ImGuiNodes &nodes, size_t count);
+
+    // Same grid as snapshot sections with ids, no editor involved, e.g. for graphs that only fit paged
+    void MakeSnapshot(ImGui::ImGuiNodesSnapshotData &data, size_t count);
+
+    // Undecorated editor window covering the whole display
+    void ShowWindow(ImGui::ImGuiNodes &nodes);
+}
+
+#endif // !BENCHMARK_GRAPH_H
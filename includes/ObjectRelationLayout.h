@@ -3,19 +3,93 @@
 
 #include <imgui/imgui.h>
 
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
+// How the layout reaches a tree in place, Object is the type of its nodes: GetChildrens(object) is a range of
+// the child pointers in order and SetPosition(object, position) receives the top left corner
+template <typename Access>
+concept ObjectRelationAccess = requires(Access &access, typename Access::Object *object, ImVec2 position) {
+    { access.GetChildrens(object) } -> std::ranges::input_range;
+    requires std::convertible_to<std::ranges::range_value_t<decltype(access.GetChildrens(object))>, typename Access::Object *>;
+    access.SetPosition(object, position);
+};
+
+// GetSize(object) is optional, without it or when it is zero the object size of the layout is taken
+template <typename Access>
+concept ObjectRelationSizedAccess = ObjectRelationAccess<Access> && requires(Access &access, typename Access::Object *object) {
+    { access.GetSize(object) } -> std::convertible_to<ImVec2>;
+};
+
 class ObjectRelationLayout
 {
 public:
     struct ObjectInfoProxy
     {
         ImVec2 position;
+        ImVec2 size; // of the object, zero takes the object size of the layout
         std::vector<ObjectInfoProxy *> childrens;
     };
 
+    // A tree by indices, the childrens of object i are childIndices[childOffsets[i], childOffsets[i + 1])
+    struct FlatTree
+    {
+        std::span<const uint32_t> childOffsets; // one more than objects
+        std::span<const uint32_t> childIndices;
+        std::span<const ImVec2> sizes; // optional, one per object
+    };
+
+    enum class Mode
+    {
+        Rows, // one row per object, every level shifted to center on its parents
+        Tidy  // Reingold-Tilford, subtrees packed against each other along their contours in O(N)
+    };
+
 public:
+    // objects are packed by their own size, every depth is one column as wide as its widest object
+    // the access is only used during the call, the tree is never copied
+    template <ObjectRelationAccess Access>
+    void MakeLayout(Access &access, typename Access::Object *root)
+    {
+        Bind(access);
+        LayoutTree(root);
+    }
+
     void MakeLayout(ObjectInfoProxy *root);
+    // positions[i] receives the top left corner of object i, objects outside the tree keep theirs
+    void MakeLayout(const FlatTree &tree, uint32_t root, std::span<ImVec2> positions);
+    // parents[i] is the parent of object i and UINT32_MAX for the root, siblings are ordered by their index
+    void MakeLayout(std::span<const uint32_t> parents, std::span<ImVec2> positions, std::span<const ImVec2> sizes = {});
+
+    // the childrens or the size of the object changed, a moved object invalidates its old and new parent
+    void Invalidate(const void *object);
+    // the tidy mode redoes only the invalidated objects and their ancestors, subtrees keep their contours and
+    // only objects that really move are written, the root may move to stay centered on its childrens
+    // the rows mode lays out the whole tree again, the access has to reach the tree of the last MakeLayout()
+    template <ObjectRelationAccess Access>
+    void UpdateLayout(Access &access)
+    {
+        Bind(access);
+        UpdateTree();
+    }
+
+    void UpdateLayout();
+    // object i of a flat tree is invalidated as &positions[i]
+    void UpdateLayout(const FlatTree &tree, std::span<ImVec2> positions);
+    // positions written by the last layout
+    size_t GetPlacedCount() const { return m_placedCount; }
+
+    void SetMode(Mode mode) { m_mode = mode; }
+    Mode GetMode() const { return m_mode; }
+    // the full tidy layout hands large subtrees to this many threads, one by default and zero for all cores,
+    // with more SetPosition() of the access is called from several threads at once, each time for a different
+    // object, so only opt in when the access allows that
+    void SetThreads(int threads) { m_threads = threads; }
 
 public:
     ObjectRelationLayout(ImVec2 rootPosition, ImVec2 objectSize, ImVec2 objectSpacing);
@@ -24,26 +98,232 @@ public:
     virtual ~ObjectRelationLayout() {}
 
 private:
-    void CalculateLevelGroups(ObjectInfoProxy *root, size_t depth = 0);
+    static constexpr uint32_t None = UINT32_MAX;
 
-    void CalculateDefaultLayout(ObjectInfoProxy *root, size_t depth = 0);
-    void CalculateCenterLayout(ObjectInfoProxy *root, size_t depth = 0);
-
-private:
     struct Level
     {
         size_t level;
         size_t groupsCount;
-        std::vector<ObjectInfoProxy *> groupParents;
+        size_t visited;
+        uint32_t middleParent; // into m_rows, the level is centered on its middle child
 
         float deltaY;
     };
 
+    struct Visit
+    {
+        const void *object;
+        uint32_t parent; // into m_rows
+        uint32_t number; // among its siblings
+        size_t depth;
+    };
+
+    // Objects of the rows mode in preorder, positions are only handed out once they are final
+    struct Row
+    {
+        const void *object;
+        size_t depth;
+        uint32_t childCount;
+        uint32_t middleChild; // the one the next level centers on
+        float y;
+        float height;
+    };
+
+    // Indices into m_tidyNodes, the children of an object are one range, breadth first after a full layout
+    struct TidyNode
+    {
+        const void *object = nullptr;
+        uint32_t parent = None;
+        uint32_t firstChild = 0;
+        uint32_t childCount = 0;
+        uint32_t number = 0; // among its siblings
+        uint32_t thread = None; // next object on the contour of a leaf
+        uint32_t ancestor = 0;
+        uint32_t depth = 0;
+        uint32_t firstRecord = 0;
+        uint32_t recordCount = 0;
+        float height = 0.f;
+        bool dirty = false;
+        bool kept = false;
+
+        double prelim = 0.0; // of the center, starts at the midpoint of the children until the parent places the object
+        double midpoint = 0.0;
+        double mod = 0.0;
+        double shift = 0.0; // sum of the ancestor mods in the second walk
+        double change = 0.0;
+        double center = 0.0; // where the object was placed last
+
+        uint32_t NextLeft() const { return childCount ? firstChild : thread; }
+        uint32_t NextRight() const { return childCount ? firstChild + childCount - 1 : thread; }
+    };
+
+    // a node as it was before a write
+    struct TidyRecord
+    {
+        uint32_t object;
+        uint32_t thread;
+        uint32_t ancestor;
+        double mod;
+    };
+
+    // subtrees whose roots are m_taskRoots[firstRoot, firstRoot + rootCount)
+    struct TidyTask
+    {
+        uint32_t firstRoot;
+        uint32_t rootCount;
+        size_t weight; // objects in the subtrees
+    };
+
+    // records are written with offsets into the own buffer and moved behind m_records afterwards
+    struct TidyWorker
+    {
+        std::vector<uint32_t> nodes;
+        std::vector<TidyRecord> records;
+        std::vector<uint32_t> recorded; // objects whose firstRecord points into records
+    };
+
+    // The access behind plain function pointers, so only the binding is instantiated per tree type
+    struct Binding
+    {
+        void *access;
+        void (*gatherChildrens)(void *access, const void *object, std::vector<const void *> &childrens);
+        ImVec2 (*getSize)(void *access, const void *object);
+        void (*setPosition)(void *access, const void *object, ImVec2 position);
+    };
+
+    struct ProxyAccess
+    {
+        using Object = ObjectInfoProxy;
+
+        const std::vector<ObjectInfoProxy *> &GetChildrens(ObjectInfoProxy *object) { return object->childrens; }
+        ImVec2 GetSize(ObjectInfoProxy *object) { return object->size; }
+        void SetPosition(ObjectInfoProxy *object, ImVec2 position) { object->position = position; }
+    };
+
+    // Every object is its own slot in the output, so positions are written into one contiguous buffer
+    struct FlatAccess
+    {
+        using Object = ImVec2;
+
+        const FlatTree &tree;
+        ImVec2 *positions;
+
+        auto GetChildrens(ImVec2 *object) const
+        {
+            const auto index = object - positions;
+
+            return tree.childIndices.subspan(tree.childOffsets[index], tree.childOffsets[index + 1] - tree.childOffsets[index]) |
+                   std::views::transform([positions = positions](uint32_t child) { return positions + child; });
+        }
+        ImVec2 GetSize(ImVec2 *object) const { return tree.sizes.empty() ? ImVec2{} : tree.sizes[object - positions]; }
+        void SetPosition(ImVec2 *object, ImVec2 position) const { *object = position; }
+    };
+
+    template <ObjectRelationAccess Access>
+    void Bind(Access &access)
+    {
+        using Object = typename Access::Object;
+
+        m_binding.access = const_cast<void *>(static_cast<const void *>(std::addressof(access)));
+        m_binding.gatherChildrens = [](void *access, const void *object, std::vector<const void *> &childrens)
+        {
+            for (auto child : static_cast<Access *>(access)->GetChildrens(static_cast<Object *>(const_cast<void *>(object))))
+                childrens.push_back(static_cast<Object *>(child));
+        };
+        m_binding.setPosition = [](void *access, const void *object, ImVec2 position)
+        {
+            static_cast<Access *>(access)->SetPosition(static_cast<Object *>(const_cast<void *>(object)), position);
+        };
+
+        if constexpr (ObjectRelationSizedAccess<Access>)
+        {
+            m_binding.getSize = [](void *access, const void *object) -> ImVec2
+            {
+                return static_cast<Access *>(access)->GetSize(static_cast<Object *>(const_cast<void *>(object)));
+            };
+        }
+        else
+            m_binding.getSize = nullptr;
+    }
+
+    void LayoutTree(const void *root);
+    void UpdateTree();
+
+    ImVec2 GetObjectSize(const void *object) const;
+    const std::vector<const void *> &GatherChildrens(const void *object);
+    void SetPosition(const void *object, ImVec2 position) const { m_binding.setPosition(m_binding.access, object, position); }
+    void FitColumn(size_t depth, float width);
+    bool CalculateColumns(); // true when a column moved
+
+    // every pass walks the tree with an explicit stack, so the depth is only bounded by memory
+    void CalculateDefaultLayout(const void *root);
+    void CalculateLevelGroups();
+    void CalculateCenterLayout();
+
+    // Walker's algorithm with Buchheim's linear time threads and shifts, the first walk runs over the
+    // breadth first order backwards so children are done before their parents and siblings are adjacent
+    void CalculateTidyLayout(const void *root, bool keepOrigin);
+    void FlattenTree(const void *root);
+    void AppendChildren(uint32_t object);
+    double GetSeparation(uint32_t left, uint32_t right) const;
+    uint32_t Apportion(uint32_t object, uint32_t defaultAncestor, std::vector<TidyRecord> &records);
+    void MoveSubtree(uint32_t left, uint32_t right, double shift);
+    void ExecuteShifts(uint32_t object);
+    void PlaceNode(const TidyNode &node, std::vector<uint32_t> &stack, bool all);
+    size_t PlaceSubtree(uint32_t object, std::vector<uint32_t> &stack, bool all);
+    void PlaceTidyNodes(bool all);
+
+    // Subtrees below the cutoff never share a node, so the first and the second walk of each one can run on
+    // its own thread, only the few objects above them are combined afterwards
+    int GetTidyThreads() const;
+    void PartitionTidyNodes(size_t cutoff);
+    void CombineTask(const TidyTask &task, TidyWorker &worker);
+
+    // Placing the childrens of an object only writes into its own subtree, what it writes below the
+    // childrens is recorded so the object can be placed again without touching the other subtrees
+    void Record(std::vector<TidyRecord> &records, uint32_t object) const;
+    void Combine(uint32_t object, std::vector<TidyRecord> &records);
+    void Uncombine(uint32_t object);
+    void RemoveSubtree(uint32_t object);
+    void ReplaceChildren(uint32_t object);
+    void CompactRecords();
+
     ImVec2 m_rootPosition;
     ImVec2 m_objectSize;
     ImVec2 m_objectSpacing;
+    Mode m_mode = Mode::Rows;
+    int m_threads = 1;
 
+    // all state of a layout lives here, separate layout objects can run on separate threads
+    Binding m_binding = {};
+    float m_currentY = 0.f;
+    std::vector<const void *> m_childrens;
+    std::vector<Visit> m_stack;
+    std::vector<Row> m_rows;
+    std::vector<float> m_columns; // widest object of a depth
+    std::vector<float> m_columnX;
     std::vector<Level> m_levelGroupInfo;
+    std::vector<TidyNode> m_tidyNodes;
+
+    // kept between layouts for UpdateLayout(), the index is only built by the first update
+    const void *m_root = nullptr;
+    double m_tidyOrigin = 0.0; // prelim of the top of the root
+    size_t m_placedCount = 0;
+    size_t m_deadCount = 0;
+    size_t m_liveRecords = 0;
+    std::vector<TidyRecord> m_records;
+    std::unordered_map<const void *, uint32_t> m_tidyIndex;
+    std::vector<const void *> m_invalid;
+    std::vector<uint32_t> m_changed;
+    std::vector<uint32_t> m_dirty;
+    std::vector<uint32_t> m_tidyStack;
+    std::vector<uint32_t> m_upperNodes; // above the tasks, breadth first
+    std::vector<uint32_t> m_taskRoots;
+    std::vector<TidyTask> m_tasks;
+    std::vector<size_t> m_subtreeSizes;
+    std::vector<TidyWorker> m_tidyWorkers;
+    std::vector<uint32_t> m_flatOffsets; // of the tree built from a parent array
+    std::vector<uint32_t> m_flatChildren;
 };
 
-#endif // !OBJECT_RELATION_LAYOUT_H
\ No newline at end of file
+#endif // !OBJECT_RELATION_LAYOUT_H
@@ -1,13 +1,419 @@
 #include "ImGuiNodes.h"
+#include "ImGuiNodesPager.h"
 
 #include <math.h>
 
 #include <algorithm>
+#include <chrono>
+#include <unordered_map>
 
 namespace ImGui
 {
+    static double ElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // marks the nodes of one RemoveCommandNodes() sweep, no queue hands out that many handles
+    static constexpr uint32_t ImGuiNodesRemovedHandle = UINT32_MAX;
+
+    static ImGuiNodesJournalRecord JournalRecord(ImGuiNodesNode *node, ImGuiNodesJournalOp_ op)
+    {
+        ImGuiNodesJournalRecord record = {};
+        record.node_ = node;
+        record.op_ = op;
+        return record;
+    }
+
+    void *ImGuiNodesFrameArena::Allocate(size_t size, size_t alignment)
+    {
+        size_t offset = (used_ + alignment - 1) & ~(alignment - 1);
+
+        requested_ += size + alignment;
+
+        if (offset + size <= capacity_)
+        {
+            used_ = offset + size;
+            return block_.get() + offset;
+        }
+
+        unsigned char *block = overflow_.emplace_back(new unsigned char[size + alignment]).get();
+        return block + ((alignment - reinterpret_cast<uintptr_t>(block) % alignment) % alignment);
+    }
+
+    void ImGuiNodesFrameArena::Reset()
+    {
+        if (false == overflow_.empty())
+        {
+            capacity_ = ImMax(capacity_ * 2, requested_);
+            block_.reset(new unsigned char[capacity_]);
+            overflow_.clear();
+        }
+
+        used_ = 0;
+        requested_ = 0;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    size_t ImGuiNodesJournal::NodeBytes(const ImGuiNodesNode *node)
+    {
+        return sizeof(ImGuiNodesNode) + node->inputs_.capacity() * sizeof(ImGuiNodesInput) + node->outputs_.capacity() * sizeof(ImGuiNodesOutput);
+    }
+
+    size_t ImGuiNodesJournal::GetBytes() const
+    {
+        return (records_.size() - records_head_) * sizeof(ImGuiNodesJournalRecord) + (steps_.size() - steps_head_) * sizeof(uint32_t) + owned_bytes_;
+    }
+
+    void ImGuiNodesJournal::DropRedo()
+    {
+        for (size_t record_idx = applied_; record_idx < records_.size(); ++record_idx)
+        {
+            const ImGuiNodesJournalRecord &record = records_[record_idx];
+
+            if (record.op_ == ImGuiNodesJournalOp_Create)
+            {
+                owned_bytes_ -= NodeBytes(record.node_);
+                delete record.node_;
+            }
+        }
+
+        records_.resize(applied_);
+        steps_.resize(cursor_);
+    }
+
+    void ImGuiNodesJournal::Evict()
+    {
+        // only undo steps go, the open one and everything redoable stay
+        while (GetBytes() > budget_ && cursor_ > steps_head_ + (open_ ? 1 : 0))
+        {
+            const size_t count = steps_[steps_head_++];
+
+            for (size_t record_idx = records_head_; record_idx < records_head_ + count; ++record_idx)
+            {
+                const ImGuiNodesJournalRecord &record = records_[record_idx];
+
+                if (record.op_ == ImGuiNodesJournalOp_Delete)
+                {
+                    owned_bytes_ -= NodeBytes(record.node_);
+                    delete record.node_;
+                }
+            }
+
+            records_head_ += count;
+        }
+
+        if (records_head_ > 0 && records_head_ >= records_.size() / 2)
+        {
+            records_.erase(records_.begin(), records_.begin() + records_head_);
+            applied_ -= records_head_;
+            records_head_ = 0;
+        }
+
+        if (steps_head_ > 0 && steps_head_ >= steps_.size() / 2)
+        {
+            steps_.erase(steps_.begin(), steps_.begin() + steps_head_);
+            cursor_ -= steps_head_;
+            steps_head_ = 0;
+        }
+    }
+
+    void ImGuiNodesJournal::Begin()
+    {
+        if (open_)
+            End();
+
+        DropRedo();
+        steps_.push_back(0);
+        ++cursor_;
+        open_ = true;
+    }
+
+    void ImGuiNodesJournal::End()
+    {
+        if (false == open_)
+            return;
+
+        open_ = false;
+
+        if (steps_.back() == 0)
+        {
+            steps_.pop_back();
+            --cursor_;
+            return;
+        }
+
+        Close();
+    }
+
+    // a link from or to a forgotten node reads as unconnected on that side, only records of the nodes themselves go
+    static bool Forgets(ImGuiNodesJournalRecord &record, const std::vector<const ImGuiNodesNode *> &forgotten)
+    {
+        const auto contains = [&](const ImGuiNodesNode *node)
+        { return node && std::binary_search(forgotten.begin(), forgotten.end(), node); };
+
+        if (contains(record.node_))
+            return true;
+
+        if (record.op_ != ImGuiNodesJournalOp_Link)
+            return false;
+
+        for (size_t side = 0; side < 2; ++side)
+        {
+            if (false == contains(record.outputs_[side]))
+                continue;
+
+            record.outputs_[side] = NULL;
+            record.output_slots_[side] = 0;
+        }
+
+        return record.outputs_[0] == record.outputs_[1] && record.output_slots_[0] == record.output_slots_[1];
+    }
+
+    void ImGuiNodesJournal::BeginAside()
+    {
+        if (open_)
+        {
+            // without redo the open step is the last one, so its records are at the end
+            const uint32_t count = steps_.back();
+
+            held_.assign(records_.end() - count, records_.end());
+            records_.resize(records_.size() - count);
+            applied_ -= count;
+            steps_.pop_back();
+            --cursor_;
+            open_ = false;
+            holding_ = true;
+        }
+
+        Begin();
+    }
+
+    void ImGuiNodesJournal::EndAside()
+    {
+        // the held step comes after the aside one in the history, so it must not touch the nodes that one deleted
+        forgotten_.clear();
+
+        for (size_t record_idx = records_.size() - (open_ && holding_ ? steps_.back() : 0); record_idx < records_.size(); ++record_idx)
+        {
+            if (records_[record_idx].op_ == ImGuiNodesJournalOp_Delete)
+                forgotten_.push_back(records_[record_idx].node_);
+        }
+
+        End();
+
+        if (false == holding_)
+            return;
+
+        holding_ = false;
+
+        if (false == forgotten_.empty())
+        {
+            std::sort(forgotten_.begin(), forgotten_.end());
+            ForgetHeld();
+        }
+
+        records_.insert(records_.end(), held_.begin(), held_.end());
+        applied_ += held_.size();
+        steps_.push_back(static_cast<uint32_t>(held_.size()));
+        ++cursor_;
+        open_ = true;
+
+        held_.clear();
+    }
+
+    void ImGuiNodesJournal::Forget(ImGuiNodesNode *const *nodes, size_t count)
+    {
+        if (0 == count || (records_.size() == records_head_ && held_.empty()))
+            return;
+
+        forgotten_.assign(nodes, nodes + count);
+        std::sort(forgotten_.begin(), forgotten_.end());
+
+        // the nodes are in the graph, so no record dropped here owns a node
+        size_t read = records_head_;
+        size_t write = records_head_;
+        size_t applied = records_head_;
+        size_t steps = steps_head_;
+        size_t cursor = steps_head_;
+
+        for (size_t step_idx = steps_head_; step_idx < steps_.size(); ++step_idx)
+        {
+            uint32_t kept = 0;
+
+            for (uint32_t record_idx = 0; record_idx < steps_[step_idx]; ++record_idx, ++read)
+            {
+                if (Forgets(records_[read], forgotten_))
+                    continue;
+
+                if (read < applied_)
+                    ++applied;
+
+                records_[write++] = records_[read];
+                ++kept;
+            }
+
+            if (0 == kept && false == (open_ && step_idx + 1 == steps_.size()))
+                continue;
+
+            if (step_idx < cursor_)
+                ++cursor;
+
+            steps_[steps++] = kept;
+        }
+
+        records_.resize(write);
+        steps_.resize(steps);
+        applied_ = applied;
+        cursor_ = cursor;
+
+        ForgetHeld();
+    }
+
+    void ImGuiNodesJournal::ForgetHeld()
+    {
+        size_t held = 0;
+
+        for (ImGuiNodesJournalRecord &record : held_)
+        {
+            if (false == Forgets(record, forgotten_))
+                held_[held++] = record;
+        }
+
+        held_.resize(held);
+    }
+
+    void ImGuiNodesJournal::Push(const ImGuiNodesJournalRecord &record)
+    {
+        if (false == open_)
+        {
+            DropRedo();
+            steps_.push_back(0);
+            ++cursor_;
+        }
+
+        records_.push_back(record);
+        ++steps_.back();
+        ++applied_;
+
+        if (record.op_ == ImGuiNodesJournalOp_Delete)
+            owned_bytes_ += NodeBytes(record.node_);
+
+        if (false == open_)
+            Close();
+    }
+
+    void ImGuiNodesJournal::Close()
+    {
+        if (sink_)
+            sink_(sink_user_data_, records_.data() + applied_ - steps_.back(), steps_.back());
+
+        Evict();
+    }
+
+    void ImGuiNodesJournal::Extend(ImVec2 delta)
+    {
+        if (false == open_)
+            return;
+
+        for (size_t record_idx = applied_ - steps_.back(); record_idx < applied_; ++record_idx)
+        {
+            ImGuiNodesJournalRecord &record = records_[record_idx];
+
+            if (record.op_ == ImGuiNodesJournalOp_Translate)
+            {
+                record.delta_[0] += delta.x;
+                record.delta_[1] += delta.y;
+            }
+        }
+    }
+
+    const ImGuiNodesJournalRecord *ImGuiNodesJournal::Undo(size_t &count)
+    {
+        End();
+
+        if (false == CanUndo())
+            return NULL;
+
+        count = steps_[--cursor_];
+        applied_ -= count;
+
+        for (size_t record_idx = applied_; record_idx < applied_ + count; ++record_idx)
+        {
+            const ImGuiNodesJournalRecord &record = records_[record_idx];
+
+            if (record.op_ == ImGuiNodesJournalOp_Delete)
+                owned_bytes_ -= NodeBytes(record.node_);
+            else if (record.op_ == ImGuiNodesJournalOp_Create)
+                owned_bytes_ += NodeBytes(record.node_);
+        }
+
+        return records_.data() + applied_;
+    }
+
+    const ImGuiNodesJournalRecord *ImGuiNodesJournal::Redo(size_t &count)
+    {
+        End();
+
+        if (false == CanRedo())
+            return NULL;
+
+        count = steps_[cursor_++];
+
+        for (size_t record_idx = applied_; record_idx < applied_ + count; ++record_idx)
+        {
+            const ImGuiNodesJournalRecord &record = records_[record_idx];
+
+            if (record.op_ == ImGuiNodesJournalOp_Delete)
+                owned_bytes_ += NodeBytes(record.node_);
+            else if (record.op_ == ImGuiNodesJournalOp_Create)
+                owned_bytes_ -= NodeBytes(record.node_);
+        }
+
+        applied_ += count;
+        return records_.data() + applied_ - count;
+    }
+
+    void ImGuiNodesJournal::Clear()
+    {
+        for (size_t record_idx = records_head_; record_idx < records_.size(); ++record_idx)
+        {
+            const ImGuiNodesJournalRecord &record = records_[record_idx];
+
+            const bool owned = record_idx < applied_ ? record.op_ == ImGuiNodesJournalOp_Delete : record.op_ == ImGuiNodesJournalOp_Create;
+            if (owned)
+                delete record.node_;
+        }
+
+        for (const ImGuiNodesJournalRecord &record : held_)
+            if (record.op_ == ImGuiNodesJournalOp_Delete)
+                delete record.node_;
+
+        records_.clear();
+        steps_.clear();
+        held_.clear();
+        holding_ = false;
+        records_head_ = 0;
+        steps_head_ = 0;
+        cursor_ = 0;
+        applied_ = 0;
+        owned_bytes_ = 0;
+        open_ = false;
+    }
+
+    void ImGuiNodesJournal::SetBudget(size_t bytes)
+    {
+        budget_ = bytes;
+        Evict();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
     void ImGuiNodes::UpdateCanvasGeometry(ImDrawList *draw_list)
     {
+        IMGUI_NODES_TRACE_SCOPE("CanvasGeometry");
+
         const ImGuiIO &io = ImGui::GetIO();
 
         window_focused_ = ImGui::IsWindowFocused();
@@ -118,6 +524,8 @@ namespace ImGui
 
     ImGuiNodesNode *ImGuiNodes::UpdateNodesFromCanvas()
     {
+        IMGUI_NODES_TRACE_SCOPE("HitTesting");
+
         if (nodes_.empty())
             return NULL;
 
@@ -143,10 +551,12 @@ namespace ImGui
             {
                 node->state_ |= ImGuiNodesNodeStateFlag_Visible;
                 node->state_ &= ~ImGuiNodesNodeStateFlag_Hovered;
+                stats_.visible_nodes_++;
             }
             else
             {
                 node->state_ &= ~(ImGuiNodesNodeStateFlag_Visible | ImGuiNodesNodeStateFlag_Hovered | ImGuiNodesNodeStateFlag_Marked);
+                stats_.culled_nodes_++;
                 continue;
             }
 
@@ -290,7 +700,7 @@ namespace ImGui
         return hovered_node;
     }
 
-    ImGuiNodesNode *ImGuiNodes::CreateNodeFromDesc(ImGuiNodesNodeDesc *desc, ImVec2 pos)
+    ImGuiNodesNode *ImGuiNodes::BuildNodeFromDesc(ImGuiNodesNodeDesc *desc)
     {
         IM_ASSERT(desc);
         ImGuiNodesNode *node = new ImGuiNodesNode(desc->name_, desc->type_, desc->color_);
@@ -298,6 +708,9 @@ namespace ImGui
         ImVec2 inputs;
         ImVec2 outputs;
 
+        node->inputs_.reserve(desc->inputs_.size());
+        node->outputs_.reserve(desc->outputs_.size());
+
         ////////////////////////////////////////////////////////////////////////////////
 
         for (int input_idx = 0; input_idx < desc->inputs_.size(); ++input_idx)
@@ -321,61 +734,106 @@ namespace ImGui
         ////////////////////////////////////////////////////////////////////////////////
 
         node->BuildNodeGeometry(inputs, outputs);
+        node->desc_ = desc;
+
+        return node;
+    }
+
+    ImGuiNodesNode *ImGuiNodes::CreateNodeFromDesc(ImGuiNodesNodeDesc *desc, ImVec2 pos)
+    {
+        ImGuiNodesNode *node = BuildNodeFromDesc(desc);
+        node->id_ = ++next_node_id_;
+
         node->TranslateNode(pos - node->area_node_.GetCenter());
         node->state_ |= ImGuiNodesNodeStateFlag_Visible | ImGuiNodesNodeStateFlag_Hovered | ImGuiNodesNodeStateFlag_Processing;
-        node->desc_ = desc;
 
         ////////////////////////////////////////////////////////////////////////////////
 
         if (processing_node_)
             processing_node_->state_ &= ~(ImGuiNodesNodeStateFlag_Processing);
 
+        nodes_.push_back(node);
+        journal_.Push(JournalRecord(node, ImGuiNodesJournalOp_Create));
+
         return processing_node_ = node;
     }
 
     bool ImGuiNodes::SortSelectedNodesOrder()
     {
-        bool selected = false;
-
-        std::vector<ImGuiNodesNode *> nodes_unselected;
-        nodes_unselected.reserve(nodes_.size());
-
-        std::vector<ImGuiNodesNode *> nodes_selected;
-        nodes_selected.reserve(nodes_.size());
+        ImGuiNodesNode **nodes_selected = frame_arena_.Allocate<ImGuiNodesNode *>(nodes_.size());
+        size_t selected_count = 0;
+        size_t node_idx = 0;
 
         for (ImGuiNodesNode *node : nodes_)
         {
             if (node->state_ & ImGuiNodesNodeStateFlag_Marked || node->state_ & ImGuiNodesNodeStateFlag_Selected)
             {
-                selected = true;
                 node->state_ &= ~ImGuiNodesNodeStateFlag_Marked;
                 node->state_ |= ImGuiNodesNodeStateFlag_Selected;
-                nodes_selected.push_back(node);
+                nodes_selected[selected_count++] = node;
             }
             else
-                nodes_unselected.push_back(node);
+                nodes_[node_idx++] = node;
         }
 
-        int node_idx = 0;
-
-        for (int unselected_idx = 0; unselected_idx < nodes_unselected.size(); ++unselected_idx)
-            nodes_[node_idx++] = nodes_unselected[unselected_idx];
-
-        for (int selected_idx = 0; selected_idx < nodes_selected.size(); ++selected_idx)
+        for (size_t selected_idx = 0; selected_idx < selected_count; ++selected_idx)
             nodes_[node_idx++] = nodes_selected[selected_idx];
 
-        return selected;
+        return selected_count > 0;
     }
 
     void ImGuiNodes::Update()
     {
-        const ImGuiIO &io = ImGui::GetIO();
+        IMGUI_NODES_TRACE_SCOPE("Update");
+
+        if (!batches_.empty())
+            FlushBatches();
+
+        auto start = std::chrono::steady_clock::now();
+        const int commands = ApplyCommands();
+        const double commands_time = ElapsedMilliseconds(start);
+
+        ImDrawList *draw_list = ImGui::GetWindowDrawList();
+
+        stats_ = {};
+        stats_.commands_ = commands;
+        stats_.commands_time_ = commands_time;
+        frame_arena_.Reset();
+        frame_vertices_ = draw_list->VtxBuffer.Size;
+        frame_indices_ = draw_list->IdxBuffer.Size;
+        frame_allocations_ = CountAllocations();
+
+        start = std::chrono::steady_clock::now();
+        UpdateCanvasGeometry(draw_list);
+        stats_.canvas_geometry_time_ = ElapsedMilliseconds(start);
+
+        ////////////////////////////////////////////////////////////////////////////////
 
-        UpdateCanvasGeometry(ImGui::GetWindowDrawList());
+        if (pager_)
+        {
+            start = std::chrono::steady_clock::now();
+            pager_->Update();
+            stats_.paging_time_ = ElapsedMilliseconds(start);
+        }
 
         ////////////////////////////////////////////////////////////////////////////////
 
+        start = std::chrono::steady_clock::now();
         ImGuiNodesNode *hovered_node = UpdateNodesFromCanvas();
+        stats_.nodes_from_canvas_time_ = ElapsedMilliseconds(start);
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        start = std::chrono::steady_clock::now();
+        UpdateStateMachine(hovered_node);
+        stats_.state_machine_time_ = ElapsedMilliseconds(start);
+    }
+
+    void ImGuiNodes::UpdateStateMachine(ImGuiNodesNode *hovered_node)
+    {
+        IMGUI_NODES_TRACE_SCOPE("StateMachine");
+
+        const ImGuiIO &io = ImGui::GetIO();
 
         bool consider_hover = state_ == ImGuiNodesState_Default;
         consider_hover |= state_ == ImGuiNodesState_HoveringNode;
@@ -486,9 +944,7 @@ namespace ImGui
             {
                 if (element_input_->target_)
                 {
-                    element_input_->output_->connections_--;
-                    element_input_->output_ = NULL;
-                    element_input_->target_ = NULL;
+                    LinkInput(element_node_, element_input_ - element_node_->inputs_.data(), NULL, 0);
 
                     state_ = ImGuiNodesState_DragingInput;
                 }
@@ -500,22 +956,8 @@ namespace ImGui
             {
                 IM_ASSERT(element_node_);
 
-                if (element_node_->state_ & ImGuiNodesNodeStateFlag_Collapsed)
-                {
-                    element_node_->state_ &= ~ImGuiNodesNodeStateFlag_Collapsed;
-                    element_node_->area_node_.Max.y += element_node_->body_height_;
-                    element_node_->TranslateNode(ImVec2(0.0f, element_node_->body_height_ * -0.5f));
-                }
-                else
-                {
-                    element_node_->state_ |= ImGuiNodesNodeStateFlag_Collapsed;
-                    element_node_->area_node_.Max.y -= element_node_->body_height_;
-
-                    // const ImVec2 click = (mouse_ - scroll_ - pos_) / scale_;
-                    // const ImVec2 position = click - element_node_->area_node_.GetCenter();
-
-                    element_node_->TranslateNode(ImVec2(0.0f, element_node_->body_height_ * 0.5f));
-                }
+                element_node_->ToggleCollapse();
+                journal_.Push(JournalRecord(element_node_, ImGuiNodesJournalOp_Collapse));
 
                 state_ = ImGuiNodesState_Draging;
                 return;
@@ -538,6 +980,8 @@ namespace ImGui
                 else
                     hovered_node->state_ |= (ImGuiNodesNodeStateFlag_Disabled);
 
+                journal_.Push(JournalRecord(hovered_node, ImGuiNodesJournalOp_Disable));
+
                 return;
             }
             }
@@ -638,11 +1082,48 @@ namespace ImGui
                 if (element_input_ && element_input_->output_ && element_input_->output_->connections_ > 0)
                     return;
 
+                const ImVec2 delta = io.MouseDelta / scale_;
+                if (delta.x == 0.0f && delta.y == 0.0f)
+                    return;
+
+                // the first moving frame records the dragged nodes, later frames only add up their deltas
+                const bool coalesce = journal_.IsOpen();
+                if (false == coalesce)
+                    journal_.Begin();
+
+                ImGuiNodesJournalRecord record = JournalRecord(NULL, ImGuiNodesJournalOp_Translate);
+                record.delta_[0] = delta.x;
+                record.delta_[1] = delta.y;
+
                 if (false == (element_node_->state_ & ImGuiNodesNodeStateFlag_Selected))
-                    element_node_->TranslateNode(io.MouseDelta / scale_, false);
+                {
+                    element_node_->TranslateNode(delta, false);
+
+                    if (false == coalesce)
+                    {
+                        record.node_ = element_node_;
+                        journal_.Push(record);
+                    }
+                }
                 else
                     for (int node_idx = 0; node_idx < nodes_.size(); ++node_idx)
-                        nodes_[node_idx]->TranslateNode(io.MouseDelta / scale_, true);
+                    {
+                        ImGuiNodesNode *node = nodes_[node_idx];
+
+                        if (false == (node->state_ & ImGuiNodesNodeStateFlag_Selected))
+                            continue;
+
+                        node->TranslateNode(delta);
+
+                        if (false == coalesce)
+                        {
+                            record.node_ = node;
+                            journal_.Push(record);
+                        }
+                    }
+
+                if (coalesce)
+                    journal_.Extend(delta);
 
                 return;
             }
@@ -694,6 +1175,7 @@ namespace ImGui
 
             case ImGuiNodesState_Draging:
             {
+                journal_.End();
                 state_ = ImGuiNodesState_HoveringNode;
                 return;
             }
@@ -705,13 +1187,10 @@ namespace ImGui
                 {
                     IM_ASSERT(hovered_node);
                     IM_ASSERT(element_node_);
-                    element_input_->target_ = state_ == ImGuiNodesState_DragingInput ? hovered_node : element_node_;
+                    ImGuiNodesNode *input_node = state_ == ImGuiNodesState_DragingInput ? element_node_ : hovered_node;
+                    ImGuiNodesNode *output_node = state_ == ImGuiNodesState_DragingInput ? hovered_node : element_node_;
 
-                    if (element_input_->output_)
-                        element_input_->output_->connections_--;
-
-                    element_input_->output_ = element_output_;
-                    element_output_->connections_++;
+                    LinkInput(input_node, element_input_ - input_node->inputs_.data(), output_node, element_output_ - output_node->outputs_.data());
                 }
 
                 connection_ = ImVec4();
@@ -725,93 +1204,99 @@ namespace ImGui
 
         ////////////////////////////////////////////////////////////////////////////////
 
-        if (window_focused_ && ImGui::IsKeyPressed(ImGuiKey_Delete))
+        if (window_focused_ && io.KeyCtrl && (ImGui::IsKeyPressed(ImGuiKey_Z) || ImGui::IsKeyPressed(ImGuiKey_Y)))
         {
-            std::vector<ImGuiNodesNode *> nodes;
-            nodes.reserve(nodes_.size());
-
-            for (int node_idx = 0; node_idx < nodes_.size(); ++node_idx)
-            {
-                ImGuiNodesNode *node = nodes_[node_idx];
-                IM_ASSERT(node);
+            if (ImGui::IsKeyPressed(ImGuiKey_Y) || io.KeyShift)
+                Redo();
+            else
+                Undo();
 
-                if (node->state_ & ImGuiNodesNodeStateFlag_Selected)
-                {
-                    element_node_ = NULL;
-                    element_input_ = NULL;
-                    element_output_ = NULL;
+            return;
+        }
 
-                    state_ = ImGuiNodesState_Default;
+        ////////////////////////////////////////////////////////////////////////////////
 
-                    for (int sweep_idx = 0; sweep_idx < nodes_.size(); ++sweep_idx)
-                    {
-                        ImGuiNodesNode *sweep = nodes_[sweep_idx];
-                        IM_ASSERT(sweep);
+        if (window_focused_ && ImGui::IsKeyPressed(ImGuiKey_Delete))
+        {
+            // survivors are compacted to the front in place, the doomed nodes wait in frame scratch
+            ImGuiNodesNode **nodes_deleted = frame_arena_.Allocate<ImGuiNodesNode *>(nodes_.size());
+            size_t deleted_count = 0;
+            size_t kept_count = 0;
 
-                        for (int input_idx = 0; input_idx < sweep->inputs_.size(); ++input_idx)
-                        {
-                            ImGuiNodesInput &input = sweep->inputs_[input_idx];
+            for (int node_idx = 0; node_idx < nodes_.size(); ++node_idx)
+            {
+                ImGuiNodesNode *node = nodes_[node_idx];
+                IM_ASSERT(node);
 
-                            if (node == input.target_)
-                            {
-                                if (input.output_)
-                                    input.output_->connections_--;
+                if (node->state_ & ImGuiNodesNodeStateFlag_Selected)
+                    nodes_deleted[deleted_count++] = node;
+                else
+                    nodes_[kept_count++] = node;
+            }
 
-                                input.target_ = NULL;
-                                input.output_ = NULL;
-                            }
-                        }
-                    }
+            if (0 == deleted_count)
+                return;
 
-                    for (int input_idx = 0; input_idx < node->inputs_.size(); ++input_idx)
-                    {
-                        ImGuiNodesInput &input = node->inputs_[input_idx];
+            element_node_ = NULL;
+            element_input_ = NULL;
+            element_output_ = NULL;
 
-                        if (input.output_)
-                            input.output_->connections_--;
+            state_ = ImGuiNodesState_Default;
 
-                        input.type_ = ImGuiNodesNodeType_None;
-                        input.name_ = NULL;
-                        input.target_ = NULL;
-                        input.output_ = NULL;
-                    }
+            // the deleted nodes move into the journal, undo brings them back with their links
+            journal_.Begin();
+
+            for (size_t deleted_idx = 0; deleted_idx < deleted_count; ++deleted_idx)
+            {
+                ImGuiNodesNode *node = nodes_deleted[deleted_idx];
 
-                    for (int output_idx = 0; output_idx < node->outputs_.size(); ++output_idx)
+                // only nodes still alive are swept, the ones deleted before already dropped their links
+                for (size_t sweep_idx = 0; sweep_idx < kept_count + deleted_count - deleted_idx; ++sweep_idx)
+                {
+                    ImGuiNodesNode *sweep = sweep_idx < kept_count ? nodes_[sweep_idx] : nodes_deleted[deleted_idx + sweep_idx - kept_count];
+                    IM_ASSERT(sweep);
+
+                    for (int input_idx = 0; input_idx < sweep->inputs_.size(); ++input_idx)
                     {
-                        ImGuiNodesOutput &output = node->outputs_[output_idx];
-                        IM_ASSERT(output.connections_ == 0);
+                        ImGuiNodesInput &input = sweep->inputs_[input_idx];
+
+                        if (node == input.target_)
+                            LinkInput(sweep, input_idx, NULL, 0);
                     }
+                }
 
-                    if (node == processing_node_)
-                        processing_node_ = NULL;
+                for (int input_idx = 0; input_idx < node->inputs_.size(); ++input_idx)
+                {
+                    if (node->inputs_[input_idx].target_)
+                        LinkInput(node, input_idx, NULL, 0);
+                }
 
-                    delete node;
+                for (int output_idx = 0; output_idx < node->outputs_.size(); ++output_idx)
+                {
+                    ImGuiNodesOutput &output = node->outputs_[output_idx];
+                    IM_ASSERT(output.connections_ == 0);
                 }
-                else
+
+                if (node == processing_node_)
                 {
-                    nodes.push_back(node);
+                    node->state_ &= ~ImGuiNodesNodeStateFlag_Processing;
+                    processing_node_ = NULL;
                 }
+
+                ForgetCommandNode(node);
+                journal_.Push(JournalRecord(node, ImGuiNodesJournalOp_Delete));
             }
 
-            nodes_ = nodes;
+            nodes_.resize(kept_count);
+            journal_.End();
 
             return;
         }
     }
 
-    void ImGuiNodes::ProcessNodes()
+    void ImGuiNodes::DrawWires(const ImRect &clip, ImVec2 offset)
     {
-        ImDrawList *draw_list = ImGui::GetWindowDrawList();
-
-        const ImVec2 offset = pos_ + scroll_;
-
-        ////////////////////////////////////////////////////////////////////////////////
-
-        ImGui::SetWindowFontScale(scale_);
-
-        ImVec2 canvasMin = ImGui::GetWindowContentRegionMin() + ImGui::GetWindowPos() + ImVec2{1.f, 1.f};
-        ImVec2 canvasMax = ImGui::GetWindowContentRegionMax() + ImGui::GetWindowPos() - ImVec2{1.f, 1.f};
-        ImGui::PushClipRect(canvasMin, canvasMax, false);
+        IMGUI_NODES_TRACE_SCOPE("Wires");
 
         for (int node_idx = 0; node_idx < nodes_.size(); ++node_idx)
         {
@@ -851,17 +1336,68 @@ namespace ImGui
                         p4 += (input.output_->pos_ * scale_);
                     }
 
+                    // the curve stays inside the hull of its control points, see DrawConnection()
+                    ImRect bounds(ImMin(p1, p4), ImMax(p1, p4));
+                    bounds.Expand(ImVec2(25.0f * scale_, 1.5f * scale_));
+
+                    if (false == clip.Overlaps(bounds))
+                    {
+                        stats_.culled_wires_++;
+                        continue;
+                    }
+
+                    stats_.visible_wires_++;
                     DrawConnection(p1, p4, ImColor(1.0f, 1.0f, 1.0f, 1.0f));
                 }
             }
         }
+    }
+
+    void ImGuiNodes::DrawNodes(ImDrawList *draw_list, ImVec2 offset)
+    {
+        IMGUI_NODES_TRACE_SCOPE("Nodes");
+
+        double max_time = 0.0;
+
+        if (profile_overlay_)
+            for (int node_idx = 0; node_idx < nodes_.size(); ++node_idx)
+                max_time = ImMax(max_time, nodes_[node_idx]->profile_.time_);
 
         for (int node_idx = 0; node_idx < nodes_.size(); ++node_idx)
         {
             const ImGuiNodesNode *node = nodes_[node_idx];
             IM_ASSERT(node);
-            node->DrawNode(draw_list, offset, scale_, state_);
+
+            float heat = -1.0f;
+            if (profile_overlay_)
+                heat = max_time > 0.0 ? float(node->profile_.time_ / max_time) : 0.0f;
+
+            node->DrawNode(draw_list, offset, scale_, state_, heat);
         }
+    }
+
+    void ImGuiNodes::ProcessNodes()
+    {
+        IMGUI_NODES_TRACE_SCOPE("ProcessNodes");
+
+        const auto start = std::chrono::steady_clock::now();
+
+        ImDrawList *draw_list = ImGui::GetWindowDrawList();
+
+        const ImVec2 offset = pos_ + scroll_;
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        ImGui::SetWindowFontScale(scale_);
+
+        ImVec2 canvasMin = ImGui::GetWindowContentRegionMin() + ImGui::GetWindowPos() + ImVec2{1.f, 1.f};
+        ImVec2 canvasMax = ImGui::GetWindowContentRegionMax() + ImGui::GetWindowPos() - ImVec2{1.f, 1.f};
+        ImGui::PushClipRect(canvasMin, canvasMax, false);
+
+        const ImRect clip(canvasMin, canvasMax);
+
+        DrawWires(clip, offset);
+        DrawNodes(draw_list, offset);
 
         if (connection_.x != connection_.z && connection_.y != connection_.w)
             DrawConnection(ImVec2(connection_.x, connection_.y), ImVec2(connection_.z, connection_.w), ImColor(0.0f, 1.0f, 0.0f, 1.0f));
@@ -880,43 +1416,90 @@ namespace ImGui
 
         ////////////////////////////////////////////////////////////////////////////////
 
+        stats_.vertices_ = draw_list->VtxBuffer.Size - frame_vertices_;
+        stats_.indices_ = draw_list->IdxBuffer.Size - frame_indices_;
+        stats_.allocations_ = CountAllocations() - frame_allocations_;
+        stats_.process_nodes_time_ = ElapsedMilliseconds(start);
+
+        if (stats_overlay_)
+            DrawStatsOverlay(draw_list, canvasMin);
+    }
+
+    void ImGuiNodes::DrawStatsOverlay(ImDrawList *draw_list, ImVec2 pos)
+    {
         const char *text, *text_end;
+        const float line = ImGui::GetFontSize() + 8.f;
 
-        canvasMin += ImVec2{20.f, 16.f};
+        pos += ImVec2{20.f, 16.f};
         ImFormatStringToTempBuffer(&text, &text_end, "Mouse: %.2f, %.2f", mouse_.x, mouse_.y);
-        draw_list->AddText(canvasMin, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
+        draw_list->AddText(pos, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
 
-        canvasMin.y += ImGui::GetFontSize() + 8.f;
+        pos.y += line;
         ImFormatStringToTempBuffer(&text, &text_end, "Scroll: %.2f, %.2f", scroll_.x, scroll_.y);
-        draw_list->AddText(canvasMin, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
+        draw_list->AddText(pos, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
 
-        canvasMin.y += ImGui::GetFontSize() + 8.f;
+        pos.y += line;
         ImFormatStringToTempBuffer(&text, &text_end, "Scale: %.2f", scale_);
-        draw_list->AddText(canvasMin, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
+        draw_list->AddText(pos, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        pos.y += ImGui::GetFontSize();
+
+        pos.y += line;
+        ImFormatStringToTempBuffer(
+            &text,
+            &text_end,
+            "Frame: %.3f ms (canvas %.3f, hit test %.3f, state %.3f, draw %.3f)",
+            stats_.canvas_geometry_time_ + stats_.nodes_from_canvas_time_ + stats_.state_machine_time_ + stats_.process_nodes_time_,
+            stats_.canvas_geometry_time_,
+            stats_.nodes_from_canvas_time_,
+            stats_.state_machine_time_,
+            stats_.process_nodes_time_);
+        draw_list->AddText(pos, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
+
+        pos.y += line;
+        ImFormatStringToTempBuffer(&text, &text_end, "Nodes: %d visible, %d culled", stats_.visible_nodes_, stats_.culled_nodes_);
+        draw_list->AddText(pos, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
+
+        pos.y += line;
+        ImFormatStringToTempBuffer(&text, &text_end, "Wires: %d visible, %d culled", stats_.visible_wires_, stats_.culled_wires_);
+        draw_list->AddText(pos, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
+
+        pos.y += line;
+        ImFormatStringToTempBuffer(&text, &text_end, "Vertices: %d, indices: %d", stats_.vertices_, stats_.indices_);
+        draw_list->AddText(pos, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
+
+        if (alloc_counter_)
+        {
+            pos.y += line;
+            ImFormatStringToTempBuffer(&text, &text_end, "Allocations: %zu", stats_.allocations_);
+            draw_list->AddText(pos, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
+        }
 
         ////////////////////////////////////////////////////////////////////////////////
 
         if (nullptr != processing_node_)
         {
-            canvasMin.y += ImGui::GetFontSize();
+            pos.y += ImGui::GetFontSize();
 
-            canvasMin.y += ImGui::GetFontSize() + 8.f;
+            pos.y += line;
             if (ImGuiNodesNamesMaxLen > strlen(processing_node_->name_))
                 ImFormatStringToTempBuffer(&text, &text_end, "Node: %s", processing_node_->name_);
             else
                 ImFormatStringToTempBuffer(&text, &text_end, "Node: %.27s...", processing_node_->name_);
-            draw_list->AddText(canvasMin, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
+            draw_list->AddText(pos, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
 
-            canvasMin.y += ImGui::GetFontSize() + 8.f;
+            pos.y += line;
             ImFormatStringToTempBuffer(&text, &text_end, "Position: %.2f %.2f", processing_node_->area_node_.Min.x, processing_node_->area_node_.Min.y);
-            draw_list->AddText(canvasMin, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
+            draw_list->AddText(pos, ImColor(1.0f, 1.0f, 1.0f, 1.0f), text, text_end);
         }
-
-        ////////////////////////////////////////////////////////////////////////////////
     }
 
     void ImGuiNodes::ProcessContextMenu()
     {
+        IMGUI_NODES_TRACE_SCOPE("ContextMenu");
+
         ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(8, 8));
 
         if (ImGui::BeginPopup("NodesContextMenu"))
@@ -926,8 +1509,7 @@ namespace ImGui
                 if (ImGui::MenuItem(node_desc.name_))
                 {
                     ImVec2 position = (mouse_ - scroll_ - pos_) / scale_;
-                    ImGuiNodesNode *node = CreateNodeFromDesc(const_cast<ImGuiNodesNodeDesc *>(&node_desc), position);
-                    nodes_.push_back(node);
+                    CreateNodeFromDesc(const_cast<ImGuiNodesNodeDesc *>(&node_desc), position);
                 }
             }
 
@@ -939,10 +1521,13 @@ namespace ImGui
 
     void ImGuiNodes::AddNodeDesc(ImGuiNodesNodeDesc &&desc)
     {
-        nodes_desc_.insert(desc);
+        auto [it, inserted] = nodes_desc_.insert(desc);
+
+        if (inserted && listener_)
+            listener_->OnNodeDesc(*this, *it);
     }
 
-    ImGuiNodesNode *ImGuiNodes::AddNode(const std::string_view &desc_name, ImVec2 pos)
+    ImGuiNodesNodeDesc *ImGuiNodes::FindNodeDesc(const std::string_view &desc_name)
     {
         if (desc_name.length() >= ImGuiNodesNamesMaxLen)
             return nullptr;
@@ -958,13 +1543,385 @@ namespace ImGui
         if (it == nodes_desc_.end())
             return nullptr;
 
-        ImGuiNodesNode *node = CreateNodeFromDesc(const_cast<ImGuiNodesNodeDesc *>(&*it), pos);
-        nodes_.push_back(node);
-        return node;
+        return const_cast<ImGuiNodesNodeDesc *>(&*it);
+    }
+
+    ImGuiNodesNode *ImGuiNodes::AddNode(const std::string_view &desc_name, ImVec2 pos)
+    {
+        ImGuiNodesNodeDesc *desc = FindNodeDesc(desc_name);
+        if (nullptr == desc)
+            return nullptr;
+
+        return CreateNodeFromDesc(desc, pos);
+    }
+
+    void ImGuiNodes::AddBatch(ImGuiNodesBatch &&batch)
+    {
+        batches_.push_back(std::move(batch));
+    }
+
+    void ImGuiNodes::FlushBatches()
+    {
+        if (batches_.empty())
+            return;
+
+        for (ImGuiNodesBatch &batch : batches_)
+            BuildBatch(batch);
+
+        batches_.clear();
+
+        if (listener_)
+            listener_->OnReset(*this);
+    }
+
+    void ImGuiNodes::BuildBatch(ImGuiNodesBatch &batch)
+    {
+        IMGUI_NODES_TRACE_SCOPE("BuildBatch");
+
+        const size_t first_node = nodes_.size();
+
+        nodes_.reserve(first_node + batch.nodes_.size());
+
+        // geometry is built right here, not on first draw, but shared: every node is a copy of the template
+        // measured once per desc, only a node with a name of its own measures that name again
+        std::unordered_map<ImGuiNodesNodeDesc *, std::unique_ptr<ImGuiNodesNode>> templates;
+
+        for (const ImGuiNodesBatchNode &record : batch.nodes_)
+        {
+            std::unique_ptr<ImGuiNodesNode> &prototype = templates[record.desc_];
+            if (!prototype)
+                prototype.reset(BuildNodeFromDesc(record.desc_));
+
+            ImGuiNodesNode *node = new ImGuiNodesNode(*prototype);
+            node->id_ = record.id_ ? record.id_ : ++next_node_id_;
+            next_node_id_ = ImMax(next_node_id_, node->id_);
+
+            if (record.name_)
+                node->SetName(record.name_);
+
+            if (record.state_ & ImGuiNodesNodeStateFlag_Collapsed)
+                node->ToggleCollapse();
+
+            if (batch.top_left_)
+                node->MoveNode(record.pos_);
+            else
+                node->TranslateNode(record.pos_ - node->area_node_.GetCenter());
+
+            node->state_ |= record.state_ & (ImGuiNodesNodeStateFlag_Disabled | ImGuiNodesNodeStateFlag_Selected);
+
+            nodes_.push_back(node);
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        for (const ImGuiNodesEdge &edge : batch.edges_)
+        {
+            IM_ASSERT(edge.output_node_ < batch.nodes_.size() && edge.input_node_ < batch.nodes_.size());
+
+            if (edge.output_node_ >= batch.nodes_.size() || edge.input_node_ >= batch.nodes_.size())
+                continue;
+
+            ImGuiNodesNode *output_node = nodes_[first_node + edge.output_node_];
+            ImGuiNodesNode *input_node = nodes_[first_node + edge.input_node_];
+
+            // slots are checked against the live desc, a file may have been written with another one
+            if (edge.output_slot_ >= output_node->outputs_.size() || edge.input_slot_ >= input_node->inputs_.size())
+                continue;
+
+            ImGuiNodesInput &input = input_node->inputs_[edge.input_slot_];
+
+            if (input.output_)
+                input.output_->connections_--;
+
+            input.target_ = output_node;
+            input.output_ = &output_node->outputs_[edge.output_slot_];
+            input.output_->connections_++;
+        }
+
+        for (std::unique_ptr<char[]> &name : batch.names_)
+            name_pool_.push_back(std::move(name));
+
+        batch.Clear();
+    }
+
+    const char *ImGuiNodesBatch::CopyName(std::string_view name)
+    {
+        char *copy = names_.emplace_back(new char[name.size() + 1]).get();
+
+        memcpy(copy, name.data(), name.size());
+        copy[name.size()] = '\0';
+
+        return copy;
+    }
+
+    void ImGuiNodesBatch::Clear()
+    {
+        nodes_.clear();
+        edges_.clear();
+        names_.clear();
+    }
+
+    ImGuiNodesCommandQueue::~ImGuiNodesCommandQueue()
+    {
+        while (ImGuiNodesCommand *command = Pop())
+            delete command;
+    }
+
+    void ImGuiNodesCommandQueue::Push(ImGuiNodesCommand *command)
+    {
+        command->next_.store(nullptr, std::memory_order_relaxed);
+
+        // between the exchange and the store the queue is cut off at prev, the consumer stops there until it is linked
+        ImGuiNodesCommand *prev = head_.exchange(command, std::memory_order_acq_rel);
+        prev->next_.store(command, std::memory_order_release);
+    }
+
+    ImGuiNodesCommand *ImGuiNodesCommandQueue::Pop()
+    {
+        ImGuiNodesCommand *tail = tail_;
+        ImGuiNodesCommand *next = tail->next_.load(std::memory_order_acquire);
+
+        if (tail == &stub_)
+        {
+            if (nullptr == next)
+                return nullptr;
+
+            tail_ = next;
+            tail = next;
+            next = next->next_.load(std::memory_order_acquire);
+        }
+
+        if (next)
+        {
+            tail_ = next;
+            return tail;
+        }
+
+        if (tail != head_.load(std::memory_order_acquire))
+            return nullptr;
+
+        // the last command is only handed out once the stub queued behind it
+        Push(&stub_);
+
+        next = tail->next_.load(std::memory_order_acquire);
+
+        if (next)
+        {
+            tail_ = next;
+            return tail;
+        }
+
+        return nullptr;
+    }
+
+    uint32_t ImGuiNodesCommandQueue::AddNode(ImGuiNodesNodeDesc *desc, ImVec2 pos, const char *name)
+    {
+        IM_ASSERT(desc);
+
+        ImGuiNodesCommand *command = new ImGuiNodesCommand;
+        command->type_ = ImGuiNodesCommandType_AddNode;
+        command->desc_ = desc;
+        command->pos_ = pos;
+        command->output_node_ = next_handle_.fetch_add(1, std::memory_order_relaxed) + 1;
+
+        if (name)
+        {
+            const size_t length = strlen(name);
+
+            command->name_.reset(new char[length + 1]);
+            memcpy(command->name_.get(), name, length + 1);
+        }
+
+        const uint32_t handle = command->output_node_;
+        Push(command);
+
+        return handle;
+    }
+
+    void ImGuiNodesCommandQueue::AddConnection(uint32_t output_node, size_t output_slot, uint32_t input_node, size_t input_slot)
+    {
+        ImGuiNodesCommand *command = new ImGuiNodesCommand;
+        command->type_ = ImGuiNodesCommandType_AddConnection;
+        command->output_node_ = output_node;
+        command->output_slot_ = static_cast<uint32_t>(output_slot);
+        command->input_node_ = input_node;
+        command->input_slot_ = static_cast<uint32_t>(input_slot);
+
+        Push(command);
+    }
+
+    void ImGuiNodesCommandQueue::RemoveConnection(uint32_t output_node, size_t output_slot, uint32_t input_node, size_t input_slot)
+    {
+        ImGuiNodesCommand *command = new ImGuiNodesCommand;
+        command->type_ = ImGuiNodesCommandType_RemoveConnection;
+        command->output_node_ = output_node;
+        command->output_slot_ = static_cast<uint32_t>(output_slot);
+        command->input_node_ = input_node;
+        command->input_slot_ = static_cast<uint32_t>(input_slot);
+
+        Push(command);
+    }
+
+    void ImGuiNodesCommandQueue::RemoveNode(uint32_t node)
+    {
+        ImGuiNodesCommand *command = new ImGuiNodesCommand;
+        command->type_ = ImGuiNodesCommandType_RemoveNode;
+        command->output_node_ = node;
+
+        Push(command);
+    }
+
+    int ImGuiNodes::ApplyCommands()
+    {
+        IMGUI_NODES_TRACE_SCOPE("Commands");
+
+        const auto start = std::chrono::steady_clock::now();
+        int applied = 0;
+
+        while (0.0 >= command_budget_ || 0 == applied || ElapsedMilliseconds(start) < command_budget_)
+        {
+            std::unique_ptr<ImGuiNodesCommand> command(commands_.Pop());
+            if (!command)
+                break;
+
+            // a drag keeps its step open over frames, the commands get a step of their own before it
+            if (0 == applied++)
+                journal_.BeginAside();
+
+            // commands naming a node that is not in the graph (anymore) are dropped
+            switch (command->type_)
+            {
+            case ImGuiNodesCommandType_AddNode:
+            {
+                ImGuiNodesNode *node = BuildNodeFromDesc(command->desc_);
+                node->id_ = ++next_node_id_;
+                node->handle_ = command->output_node_;
+
+                if (command->name_)
+                {
+                    node->own_name_ = std::move(command->name_);
+                    node->SetName(node->own_name_.get());
+                }
+
+                node->TranslateNode(command->pos_ - node->area_node_.GetCenter());
+
+                command_nodes_[node->handle_] = node;
+
+                nodes_.push_back(node);
+                journal_.Push(JournalRecord(node, ImGuiNodesJournalOp_Create));
+                break;
+            }
+
+            case ImGuiNodesCommandType_AddConnection:
+                AddConnection(FindCommandNode(command->output_node_), command->output_slot_, FindCommandNode(command->input_node_), command->input_slot_);
+                break;
+
+            case ImGuiNodesCommandType_RemoveConnection:
+                RemoveConnection(FindCommandNode(command->output_node_), command->output_slot_, FindCommandNode(command->input_node_), command->input_slot_);
+                break;
+
+            case ImGuiNodesCommandType_RemoveNode:
+                if (ImGuiNodesNode *node = FindCommandNode(command->output_node_))
+                {
+                    ForgetCommandNode(node);
+                    command_removed_.push_back(node);
+                }
+
+                break;
+            }
+        }
+
+        if (!command_removed_.empty())
+            RemoveCommandNodes();
+
+        if (applied)
+            journal_.EndAside();
+
+        // the drag lost its nodes, its step ends here instead of on release
+        if (applied && state_ != ImGuiNodesState_Draging)
+            journal_.End();
+
+        return applied;
+    }
+
+    void ImGuiNodes::RemoveCommandNodes()
+    {
+        // the handles are gone already, so nothing applied after a removal can link to the node and one
+        // sweep over the graph is enough for all of them, it is skipped when no removed node feeds another
+        bool linked = false;
+
+        for (ImGuiNodesNode *node : command_removed_)
+        {
+            node->handle_ = ImGuiNodesRemovedHandle;
+
+            for (const ImGuiNodesOutput &output : node->outputs_)
+                linked |= 0 != output.connections_;
+        }
+
+        for (size_t node_idx = 0; linked && node_idx < nodes_.size(); ++node_idx)
+        {
+            ImGuiNodesNode *node = nodes_[node_idx];
+
+            if (node->handle_ == ImGuiNodesRemovedHandle)
+                continue;
+
+            for (int input_idx = 0; input_idx < node->inputs_.size(); ++input_idx)
+            {
+                const ImGuiNodesNode *target = node->inputs_[input_idx].target_;
+
+                if (target && target->handle_ == ImGuiNodesRemovedHandle)
+                    LinkInput(node, input_idx, NULL, 0);
+            }
+        }
+
+        bool interrupted = false;
+
+        for (ImGuiNodesNode *node : command_removed_)
+        {
+            for (int input_idx = 0; input_idx < node->inputs_.size(); ++input_idx)
+            {
+                if (node->inputs_[input_idx].target_)
+                    LinkInput(node, input_idx, NULL, 0);
+            }
+
+            // the interaction goes on unless it involves the node, connectors may be of another node than element_node_
+            interrupted |= node == element_node_;
+            interrupted |= element_input_ >= node->inputs_.data() && element_input_ < node->inputs_.data() + node->inputs_.size();
+            interrupted |= element_output_ >= node->outputs_.data() && element_output_ < node->outputs_.data() + node->outputs_.size();
+            interrupted |= state_ == ImGuiNodesState_Draging && (node->state_ & ImGuiNodesNodeStateFlag_Selected);
+            interrupted |= 0 != (node->state_ & ImGuiNodesNodeStateFlag_Marked);
+
+            if (node == processing_node_)
+            {
+                node->state_ &= ~ImGuiNodesNodeStateFlag_Processing;
+                processing_node_ = NULL;
+            }
+
+            journal_.Push(JournalRecord(node, ImGuiNodesJournalOp_Delete));
+        }
+
+        nodes_.erase(std::remove_if(nodes_.begin(), nodes_.end(), [](ImGuiNodesNode *node)
+                                    { return node->handle_ == ImGuiNodesRemovedHandle; }),
+                     nodes_.end());
+
+        for (ImGuiNodesNode *node : command_removed_)
+            node->handle_ = 0;
+
+        command_removed_.clear();
+
+        if (false == interrupted)
+            return;
+
+        element_node_ = NULL;
+        element_input_ = NULL;
+        element_output_ = NULL;
+        state_ = ImGuiNodesState_Default;
     }
 
     void ImGuiNodes::RemoveNode(ImGuiNodesNode *node)
     {
+        ForgetCommandNode(node);
+
         element_node_ = nullptr;
         element_input_ = nullptr;
         element_output_ = nullptr;
@@ -973,15 +1930,78 @@ namespace ImGui
             processing_node_ = nullptr;
 
         nodes_.erase(std::remove(nodes_.begin(), nodes_.end(), node), nodes_.end());
+
+        UnlinkNode(node);
+        journal_.Forget(&node, 1);
+
+        if (pager_)
+            pager_->OnRemove(node);
+
+        // a step outside the journal, listeners see one deletion instead of a reset of the whole graph
+        if (listener_)
+        {
+            const ImGuiNodesJournalRecord record = JournalRecord(node, ImGuiNodesJournalOp_Delete);
+            listener_->OnStep(*this, &record, 1, false);
+        }
     }
 
     void ImGuiNodes::Clear()
+    {
+        Reset();
+
+        if (listener_)
+            listener_->OnReset(*this);
+    }
+
+    void ImGuiNodes::Reset()
     {
         element_node_ = nullptr;
         element_input_ = nullptr;
         element_output_ = nullptr;
         processing_node_ = nullptr;
         nodes_.clear();
+        batches_.clear();
+        command_nodes_.clear();
+        ++generation_;
+        journal_.Clear();
+        DetachPager();
+    }
+
+    void ImGuiNodes::MoveNodes(ImGuiNodesNode *const *nodes, const ImVec2 *positions, size_t count)
+    {
+        journal_.BeginAside();
+
+        for (size_t node_idx = 0; node_idx < count; ++node_idx)
+        {
+            ImGuiNodesNode *node = nodes[node_idx];
+            const ImVec2 delta = positions[node_idx] - node->area_node_.Min;
+
+            if (delta.x == 0.0f && delta.y == 0.0f)
+                continue;
+
+            node->TranslateNode(delta);
+
+            ImGuiNodesJournalRecord record = JournalRecord(node, ImGuiNodesJournalOp_Translate);
+            record.delta_[0] = delta.x;
+            record.delta_[1] = delta.y;
+            journal_.Push(record);
+        }
+
+        journal_.EndAside();
+    }
+
+    void ImGuiNodes::GetNodesByCost(std::vector<ImGuiNodesNode *> &nodes) const
+    {
+        nodes = nodes_;
+
+        std::stable_sort(nodes.begin(), nodes.end(), [](const ImGuiNodesNode *lhs, const ImGuiNodesNode *rhs)
+                         { return lhs->profile_.time_ > rhs->profile_.time_; });
+    }
+
+    void ImGuiNodes::ResetProfile()
+    {
+        for (ImGuiNodesNode *node : nodes_)
+            node->profile_ = {};
     }
 
     bool ImGuiNodes::IsConnection(ImGuiNodesNode *output_node, size_t output_slot, ImGuiNodesNode *input_node, size_t input_slot)
@@ -1029,9 +2049,7 @@ namespace ImGui
         if (IsConnection(output_node, output_slot, input_node, input_slot))
             return;
 
-        output_node->outputs_[output_slot].connections_++;
-        input_node->inputs_[input_slot].output_ = &output_node->outputs_[output_slot];
-        input_node->inputs_[input_slot].target_ = output_node;
+        LinkInput(input_node, input_slot, output_node, output_slot);
     }
 
     void ImGuiNodes::AddConnection(ImGuiNodesNode *output_node, ImGuiNodesNode *input_node)
@@ -1053,15 +2071,219 @@ namespace ImGui
         if (!IsConnection(output_node, output_slot, input_node, input_slot))
             return;
 
-        output_node->outputs_[output_slot].connections_--;
-        input_node->inputs_[input_slot].output_ = nullptr;
-        input_node->inputs_[input_slot].target_ = nullptr;
+        LinkInput(input_node, input_slot, nullptr, 0);
     }
 
     void ImGuiNodes::RemoveConnection(ImGuiNodesNode *output_node, ImGuiNodesNode *input_node)
     {
         RemoveConnection(output_node, 0, input_node, 0);
     }
+
+    void ImGuiNodes::SetInput(ImGuiNodesNode *input_node, size_t input_slot, ImGuiNodesNode *output_node, size_t output_slot)
+    {
+        ImGuiNodesInput &input = input_node->inputs_[input_slot];
+
+        if (input.output_)
+            input.output_->connections_--;
+
+        input.target_ = output_node;
+        input.output_ = output_node ? &output_node->outputs_[output_slot] : NULL;
+
+        if (input.output_)
+            input.output_->connections_++;
+    }
+
+    void ImGuiNodes::LinkInput(ImGuiNodesNode *input_node, size_t input_slot, ImGuiNodesNode *output_node, size_t output_slot)
+    {
+        const ImGuiNodesInput &input = input_node->inputs_[input_slot];
+
+        ImGuiNodesJournalRecord record = JournalRecord(input_node, ImGuiNodesJournalOp_Link);
+        record.slot_ = static_cast<uint16_t>(input_slot);
+        record.outputs_[0] = input.output_ ? input.target_ : NULL;
+        record.outputs_[1] = output_node;
+        record.output_slots_[0] = input.output_ ? static_cast<uint16_t>(input.output_ - input.target_->outputs_.data()) : 0;
+        record.output_slots_[1] = static_cast<uint16_t>(output_slot);
+
+        SetInput(input_node, input_slot, output_node, output_slot);
+        journal_.Push(record);
+
+        if (pager_)
+            pager_->OnLink(input_node, input_slot, output_node, output_slot);
+    }
+
+    void ImGuiNodes::JournalSink(void *user_data, const ImGuiNodesJournalRecord *records, size_t count)
+    {
+        ImGuiNodes *nodes = static_cast<ImGuiNodes *>(user_data);
+
+        if (nodes->listener_)
+            nodes->listener_->OnStep(*nodes, records, count, false);
+    }
+
+    void ImGuiNodes::SetListener(ImGuiNodesListener *listener)
+    {
+        if (listener_ && listener_ != listener)
+        {
+            ImGuiNodesListener *detached = listener_;
+            listener_ = nullptr;
+            detached->OnDetach(*this);
+        }
+
+        listener_ = listener;
+        journal_.SetSink(listener ? JournalSink : nullptr, this);
+    }
+
+    void ImGuiNodes::DetachPager()
+    {
+        if (nullptr == pager_)
+            return;
+
+        pager_->Detach();
+        pager_ = nullptr;
+    }
+
+    void ImGuiNodes::UnlinkNode(ImGuiNodesNode *node)
+    {
+        // inputs pointing at the node keep its outputs counted, without any there is nothing to look for
+        bool linked = false;
+
+        for (const ImGuiNodesOutput &output : node->outputs_)
+            linked |= 0 != output.connections_;
+
+        for (size_t node_idx = 0; linked && node_idx < nodes_.size(); ++node_idx)
+        {
+            ImGuiNodesNode *sweep = nodes_[node_idx];
+
+            for (size_t input_idx = 0; input_idx < sweep->inputs_.size(); ++input_idx)
+            {
+                if (sweep->inputs_[input_idx].target_ != node)
+                    continue;
+
+                SetInput(sweep, input_idx, NULL, 0);
+
+                if (pager_)
+                    pager_->OnLink(sweep, input_idx, NULL, 0);
+            }
+        }
+
+        for (size_t input_idx = 0; input_idx < node->inputs_.size(); ++input_idx)
+        {
+            if (NULL == node->inputs_[input_idx].target_)
+                continue;
+
+            SetInput(node, input_idx, NULL, 0);
+
+            if (pager_)
+                pager_->OnLink(node, input_idx, NULL, 0);
+        }
+    }
+
+    void ImGuiNodes::DetachNode(ImGuiNodesNode *node)
+    {
+        ForgetCommandNode(node);
+
+        if (processing_node_ == node)
+        {
+            node->state_ &= ~ImGuiNodesNodeStateFlag_Processing;
+            processing_node_ = NULL;
+        }
+
+        // undo and redo add at the back, so that is where their nodes usually are
+        if (false == nodes_.empty() && nodes_.back() == node)
+            nodes_.pop_back();
+        else
+            nodes_.erase(std::find(nodes_.begin(), nodes_.end(), node));
+
+        // wires the journal does not know of, e.g. ones a pager restored with a tile
+        UnlinkNode(node);
+    }
+
+    void ImGuiNodes::ApplyJournal(const ImGuiNodesJournalRecord *records, size_t count, bool undo)
+    {
+        element_node_ = NULL;
+        element_input_ = NULL;
+        element_output_ = NULL;
+        connection_ = ImVec4();
+        area_ = {};
+        state_ = ImGuiNodesState_Default;
+
+        for (size_t step_idx = 0; step_idx < count; ++step_idx)
+        {
+            const ImGuiNodesJournalRecord &record = records[undo ? count - step_idx - 1 : step_idx];
+            ImGuiNodesNode *node = record.node_;
+
+            switch (record.op_)
+            {
+            case ImGuiNodesJournalOp_Translate:
+            {
+                const ImVec2 delta(record.delta_[0], record.delta_[1]);
+                node->TranslateNode(undo ? ImVec2(0.0f, 0.0f) - delta : delta);
+                break;
+            }
+
+            case ImGuiNodesJournalOp_Collapse:
+                node->ToggleCollapse();
+                break;
+
+            case ImGuiNodesJournalOp_Disable:
+                node->state_ ^= ImGuiNodesNodeStateFlag_Disabled;
+                break;
+
+            case ImGuiNodesJournalOp_Link:
+                SetInput(node, record.slot_, record.outputs_[undo ? 0 : 1], record.output_slots_[undo ? 0 : 1]);
+
+                if (pager_)
+                    pager_->OnLink(node, record.slot_, record.outputs_[undo ? 0 : 1], record.output_slots_[undo ? 0 : 1]);
+
+                break;
+
+            case ImGuiNodesJournalOp_Create:
+            case ImGuiNodesJournalOp_Delete:
+            {
+                if (undo == (record.op_ == ImGuiNodesJournalOp_Create))
+                    DetachNode(node);
+                else
+                {
+                    nodes_.push_back(node);
+
+                    if (pager_)
+                        pager_->OnRestore(node);
+                }
+
+                break;
+            }
+            }
+        }
+    }
+
+    bool ImGuiNodes::Undo()
+    {
+        size_t count = 0;
+        const ImGuiNodesJournalRecord *records = journal_.Undo(count);
+        if (nullptr == records)
+            return false;
+
+        ApplyJournal(records, count, true);
+
+        if (listener_)
+            listener_->OnStep(*this, records, count, true);
+
+        return true;
+    }
+
+    bool ImGuiNodes::Redo()
+    {
+        size_t count = 0;
+        const ImGuiNodesJournalRecord *records = journal_.Redo(count);
+        if (nullptr == records)
+            return false;
+
+        ApplyJournal(records, count, false);
+
+        if (listener_)
+            listener_->OnStep(*this, records, count, false);
+
+        return true;
+    }
 }
 
 namespace ImGui
@@ -1076,23 +2298,20 @@ namespace ImGui
 
         ////////////////////////////////////////////////////////////////////////////////
 
+        // connector areas only move after construction, their sizes still match the desc
         ImVec2 inputs;
         ImVec2 outputs;
 
-        for (int input_idx = 0; input_idx < desc_->inputs_.size(); ++input_idx)
+        for (int input_idx = 0; input_idx < inputs_.size(); ++input_idx)
         {
-            ImGuiNodesInput input(desc_->inputs_[input_idx].name_, desc_->inputs_[input_idx].type_);
-
-            inputs.x = ImMax(inputs.x, input.area_input_.GetWidth());
-            inputs.y += input.area_input_.GetHeight();
+            inputs.x = ImMax(inputs.x, inputs_[input_idx].area_input_.GetWidth());
+            inputs.y += inputs_[input_idx].area_input_.GetHeight();
         }
 
-        for (int output_idx = 0; output_idx < desc_->outputs_.size(); ++output_idx)
+        for (int output_idx = 0; output_idx < outputs_.size(); ++output_idx)
         {
-            ImGuiNodesOutput output(desc_->outputs_[output_idx].name_, desc_->outputs_[output_idx].type_);
-
-            outputs.x = ImMax(outputs.x, output.area_output_.GetWidth());
-            outputs.y += output.area_output_.GetHeight();
+            outputs.x = ImMax(outputs.x, outputs_[output_idx].area_output_.GetWidth());
+            outputs.y += outputs_[output_idx].area_output_.GetHeight();
         }
 
         ////////////////////////////////////////////////////////////////////////////////
@@ -9,8 +9,15 @@
 #include <imgui/imgui.h>
 #include <imgui/imgui_internal.h>
 
+#include "ImGuiNodesTrace.h"
+
+#include <atomic>
+#include <cstdint>
 #include <vector>
+#include <memory>
+#include <type_traits>
 #include <unordered_set>
+#include <unordered_map>
 #include <string_view>
 
 namespace ImGui
@@ -54,7 +61,8 @@ namespace ImGui
         ImGuiNodesNodeStateFlag_Selected = 1 << 3,
         ImGuiNodesNodeStateFlag_Collapsed = 1 << 4,
         ImGuiNodesNodeStateFlag_Disabled = 1 << 5,
-        ImGuiNodesNodeStateFlag_Processing = 1 << 6
+        ImGuiNodesNodeStateFlag_Processing = 1 << 6,
+        ImGuiNodesNodeStateFlag_Executing = 1 << 7
     };
 
     enum ImGuiNodesState_
@@ -248,6 +256,14 @@ namespace ImGui
 
     struct ImGuiNodesNodeDesc;
 
+    // filled by the executor, time_ is seconds spent inside the node kernel
+    struct ImGuiNodesNodeProfile
+    {
+        double time_ = 0.0;
+        unsigned int calls_ = 0;
+        size_t bytes_ = 0;
+    };
+
     struct ImGuiNodesNode
     {
         ImRect area_node_;
@@ -263,6 +279,11 @@ namespace ImGui
 
         ImGuiNodesNodeDesc *desc_ = nullptr;
         void *user_data_ = nullptr;
+        uint32_t id_ = 0;     // unique within the editor and kept by snapshots, set when the editor builds the node
+        uint32_t handle_ = 0; // from ImGuiNodesCommandQueue::AddNode(), zero for every other node
+        std::shared_ptr<const char[]> own_name_; // name_ when the node owns it, e.g. one queued with it
+
+        ImGuiNodesNodeProfile profile_;
 
         void SetName(const char *name);
 
@@ -314,7 +335,8 @@ namespace ImGui
             }
         }
 
-        inline void DrawNode(ImDrawList *draw_list, ImVec2 offset, float scale, ImGuiNodesState state) const
+        // heat in [0, 1] tints the node towards red and shows its kernel time, negative heat disables the overlay
+        inline void DrawNode(ImDrawList *draw_list, ImVec2 offset, float scale, ImGuiNodesState state, float heat = -1.0f) const
         {
             if (false == (state_ & ImGuiNodesNodeStateFlag_Visible))
                 return;
@@ -326,7 +348,14 @@ namespace ImGui
 
             float rounding = title_height_ * scale * 0.3f;
 
-            ImColor head_color = color_, body_color = color_;
+            ImColor color = color_;
+            if (heat >= 0.0f)
+                color.Value = ImLerp(color_.Value, ImVec4(1.0f, 0.1f, 0.0f, color_.Value.w), ImMin(heat, 1.0f));
+
+            const bool profiled = heat >= 0.0f && profile_.calls_ > 0;
+            const bool outlined = state_ & (ImGuiNodesNodeStateFlag_Processing | ImGuiNodesNodeStateFlag_Executing) || profiled;
+
+            ImColor head_color = color, body_color = color;
             head_color.Value.x *= 0.5;
             head_color.Value.y *= 0.5;
             head_color.Value.z *= 0.5;
@@ -346,7 +375,7 @@ namespace ImGui
                     head_color.Value.w = 0.25f;
             }
 
-            if (state_ & ImGuiNodesNodeStateFlag_Processing)
+            if (outlined)
                 draw_list->AddRectFilled(node_rect.Min - outline, node_rect.Max + outline, body_color, rounding, rounding_corners_flags);
             else
                 draw_list->AddRectFilled(node_rect.Min, node_rect.Max, body_color, rounding, rounding_corners_flags);
@@ -412,15 +441,24 @@ namespace ImGui
             if (state_ & (ImGuiNodesNodeStateFlag_Marked | ImGuiNodesNodeStateFlag_Selected))
                 draw_list->AddRectFilled(node_rect.Min, node_rect.Max, ImColor(1.0f, 1.0f, 1.0f, 0.25f), rounding, rounding_corners_flags);
 
-            if (state_ & ImGuiNodesNodeStateFlag_Processing)
+            if (outlined)
             {
-                ImColor processing_color = color_;
+                ImColor processing_color = color;
                 processing_color.Value.x *= 1.5;
                 processing_color.Value.y *= 1.5;
                 processing_color.Value.z *= 1.5;
                 processing_color.Value.w = 1.0f;
 
                 draw_list->AddRect(node_rect.Min - outline, node_rect.Max + outline, processing_color, rounding, rounding_corners_flags, 2.0f * scale);
+
+                if (profiled)
+                {
+                    const char *text, *text_end;
+                    ImFormatStringToTempBuffer(&text, &text_end, "%.2f ms x%u", profile_.time_ * 1000.0, profile_.calls_);
+
+                    const ImVec2 badge = node_rect.Min - ImVec2(0.0f, outline.y + ImGui::GetFontSize());
+                    draw_list->AddText(badge, processing_color, text, text_end);
+                }
             }
             else
             {
@@ -485,9 +523,303 @@ namespace ImGui
 
     ////////////////////////////////////////////////////////////////////////////////
 
+    // nodes are indices into the ImGuiNodesBatch the edge belongs to
+    struct ImGuiNodesEdge
+    {
+        uint32_t output_node_;
+        uint32_t output_slot_;
+        uint32_t input_node_;
+        uint32_t input_slot_;
+    };
+
+    struct ImGuiNodesBatchNode
+    {
+        ImGuiNodesNodeDesc *desc_;
+        ImVec2 pos_;
+        const char *name_;          // must outlive the node like SetName(), NULL keeps the desc name
+        ImGuiNodesNodeState state_; // only collapsed, disabled and selected are applied
+        uint32_t id_;               // zero takes the next free id
+    };
+
+    // nodes and edges staged for ImGuiNodes::AddBatch(), filling it measures no text so it needs no frame
+    struct ImGuiNodesBatch
+    {
+        std::vector<ImGuiNodesBatchNode> nodes_;
+        std::vector<ImGuiNodesEdge> edges_;
+        std::vector<std::unique_ptr<char[]>> names_; // handed over to the editor together with the nodes
+        bool top_left_ = false;                      // pos_ is the top left corner instead of the center
+
+        inline void Reserve(size_t nodes, size_t edges)
+        {
+            nodes_.reserve(nodes);
+            edges_.reserve(edges);
+        }
+
+        inline uint32_t AddNode(ImGuiNodesNodeDesc *desc, ImVec2 pos, ImGuiNodesNodeState state = ImGuiNodesNodeStateFlag_Default, const char *name = NULL)
+        {
+            IM_ASSERT(desc);
+            nodes_.push_back({desc, pos, name, state, 0});
+            return static_cast<uint32_t>(nodes_.size() - 1);
+        }
+
+        inline void AddEdge(uint32_t output_node, uint32_t output_slot, uint32_t input_node, uint32_t input_slot)
+        {
+            edges_.push_back({output_node, output_slot, input_node, input_slot});
+        }
+
+        inline void AddEdges(const ImGuiNodesEdge *edges, size_t count)
+        {
+            edges_.insert(edges_.end(), edges, edges + count);
+        }
+
+        // copy owned by the batch, for names that do not outlive the call
+        const char *CopyName(std::string_view name);
+
+        void Clear();
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    enum ImGuiNodesCommandType_
+    {
+        ImGuiNodesCommandType_AddNode = 0,
+        ImGuiNodesCommandType_AddConnection,
+        ImGuiNodesCommandType_RemoveConnection,
+        ImGuiNodesCommandType_RemoveNode,
+    };
+
+    // nodes are handles from ImGuiNodesCommandQueue::AddNode()
+    struct ImGuiNodesCommand
+    {
+        std::atomic<ImGuiNodesCommand *> next_ = nullptr;
+
+        ImGuiNodesCommandType_ type_ = ImGuiNodesCommandType_AddNode;
+        ImGuiNodesNodeDesc *desc_ = nullptr;
+        ImVec2 pos_;
+        uint32_t output_node_ = 0; // also the node of AddNode and RemoveNode
+        uint32_t output_slot_ = 0;
+        uint32_t input_node_ = 0;
+        uint32_t input_slot_ = 0;
+        std::unique_ptr<char[]> name_;
+    };
+
+    // Graph edits pushed by any thread and applied by the UI thread at the start of ImGuiNodes::Update()
+    // Vyukov's intrusive MPSC queue, a push is one exchange on the head and the UI thread follows the links
+    // from the tail, so neither side ever waits for the other
+    struct ImGuiNodesCommandQueue
+    {
+    private:
+        friend struct ImGuiNodes;
+
+        alignas(64) std::atomic<ImGuiNodesCommand *> head_;
+        alignas(64) ImGuiNodesCommand *tail_;
+        ImGuiNodesCommand stub_;
+        alignas(64) std::atomic<uint32_t> next_handle_ = 0;
+
+        void Push(ImGuiNodesCommand *command);
+        // NULL once empty, or when the producer of the next command has not linked it yet
+        ImGuiNodesCommand *Pop();
+
+    public:
+        // descs are looked up beforehand, FindNodeDesc() and AddNodeDesc() stay on the UI thread
+        // pos is the center like ImGuiNodes::AddNode(), the name is copied, the handle is never zero
+        uint32_t AddNode(ImGuiNodesNodeDesc *desc, ImVec2 pos, const char *name = NULL);
+        void AddConnection(uint32_t output_node, size_t output_slot, uint32_t input_node, size_t input_slot);
+        void RemoveConnection(uint32_t output_node, size_t output_slot, uint32_t input_node, size_t input_slot);
+        // deleted like with the Delete key, undo brings it back without its handle
+        void RemoveNode(uint32_t node);
+
+        ImGuiNodesCommandQueue() : head_(&stub_), tail_(&stub_) {}
+        ImGuiNodesCommandQueue(const ImGuiNodesCommandQueue &) = delete;
+        ImGuiNodesCommandQueue &operator=(const ImGuiNodesCommandQueue &) = delete;
+        ~ImGuiNodesCommandQueue();
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // filled every frame by Update() and ProcessNodes(), times are milliseconds
+    struct ImGuiNodesStats
+    {
+        double canvas_geometry_time_ = 0.0;
+        double nodes_from_canvas_time_ = 0.0;
+        double state_machine_time_ = 0.0;
+        double process_nodes_time_ = 0.0;
+        double paging_time_ = 0.0;
+        double commands_time_ = 0.0;
+
+        int commands_ = 0; // applied from the command queue
+        int visible_nodes_ = 0;
+        int culled_nodes_ = 0;
+        int visible_wires_ = 0;
+        int culled_wires_ = 0;
+
+        // emitted into the window draw list, the HUD itself is not counted
+        int vertices_ = 0;
+        int indices_ = 0;
+
+        // only counted when an allocation counter is installed
+        size_t allocations_ = 0;
+    };
+
+    // returns the running number of heap allocations, e.g. from a counting operator new
+    typedef size_t (*ImGuiNodesAllocCounter)(void *user_data);
+
+    // bump allocator for per frame scratch storage, everything handed out dies at the next Reset()
+    struct ImGuiNodesFrameArena
+    {
+    private:
+        std::unique_ptr<unsigned char[]> block_;
+        std::vector<std::unique_ptr<unsigned char[]>> overflow_;
+        size_t capacity_ = 0;
+        size_t used_ = 0;
+        size_t requested_ = 0;
+
+    public:
+        void *Allocate(size_t size, size_t alignment);
+
+        template <typename T>
+        inline T *Allocate(size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>);
+            return static_cast<T *>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        // overflow blocks of the last frame are folded into one block, afterwards frames stop allocating
+        void Reset();
+
+        size_t GetCapacity() const { return capacity_; }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    enum ImGuiNodesJournalOp_
+    {
+        ImGuiNodesJournalOp_Translate = 0,
+        ImGuiNodesJournalOp_Collapse,
+        ImGuiNodesJournalOp_Disable,
+        ImGuiNodesJournalOp_Link,
+        ImGuiNodesJournalOp_Create,
+        ImGuiNodesJournalOp_Delete
+    };
+
+    // one change with enough state to apply it both ways, 32 bytes on 64 bit targets
+    struct ImGuiNodesJournalRecord
+    {
+        ImGuiNodesNode *node_;
+        union
+        {
+            float delta_[2];             // Translate
+            ImGuiNodesNode *outputs_[2]; // Link: output node before and after, NULL when unconnected
+        };
+        uint16_t slot_;            // Link: input slot of node_
+        uint16_t output_slots_[2]; // Link
+        uint8_t op_;
+    };
+
+    // sees every step once it is complete, before eviction can free its nodes
+    typedef void (*ImGuiNodesJournalSink)(void *user_data, const ImGuiNodesJournalRecord *records, size_t count);
+
+    // undo history as steps of records, oldest steps are evicted once it grows over the budget
+    // nodes deleted in the undo steps and created in the redo steps are not in the graph and owned here
+    struct ImGuiNodesJournal
+    {
+    private:
+        std::vector<ImGuiNodesJournalRecord> records_;
+        std::vector<uint32_t> steps_; // records per step, oldest first
+        size_t records_head_ = 0;     // records and steps before the heads are evicted
+        size_t steps_head_ = 0;
+        size_t cursor_ = 0;  // steps applied
+        size_t applied_ = 0; // records applied
+        size_t owned_bytes_ = 0;
+        size_t budget_ = 8 << 20;
+        bool open_ = false;
+        bool holding_ = false; // the open step waits in held_ during an aside step
+        std::vector<ImGuiNodesJournalRecord> held_;
+        std::vector<const ImGuiNodesNode *> forgotten_; // sorted scratch of Forget() and EndAside()
+
+        ImGuiNodesJournalSink sink_ = nullptr;
+        void *sink_user_data_ = nullptr;
+
+        void DropRedo();
+        void Evict();
+        void Close();
+        void ForgetHeld();
+
+        static size_t NodeBytes(const ImGuiNodesNode *node);
+
+    public:
+        // records pushed between Begin() and End() are undone as one step, outside they are a step each
+        void Begin();
+        void End();
+        void Push(const ImGuiNodesJournalRecord &record);
+        // adds delta to the Translate records of the open step, so a whole drag is one step
+        void Extend(ImVec2 delta);
+        bool IsOpen() const { return open_; }
+        // a step of its own while another one is open, e.g. a layout or queued commands during a drag,
+        // the open step is held back meanwhile and continues after EndAside(), so it is undone first,
+        // records of nodes the aside step deleted leave it
+        void BeginAside();
+        void EndAside();
+
+        // drops the records of nodes that are still in the graph but leave it without a step and their wires,
+        // links to them read as unconnected, steps left empty go with them, the rest of the history stays
+        void Forget(ImGuiNodesNode *const *nodes, size_t count);
+
+        // the step to apply in reverse or forward order, NULL when there is none
+        const ImGuiNodesJournalRecord *Undo(size_t &count);
+        const ImGuiNodesJournalRecord *Redo(size_t &count);
+
+        bool CanUndo() const { return cursor_ > steps_head_; }
+        bool CanRedo() const { return cursor_ < steps_.size(); }
+
+        void Clear();
+
+        void SetBudget(size_t bytes);
+        size_t GetBudget() const { return budget_; }
+        // records plus the nodes kept alive for them
+        size_t GetBytes() const;
+
+        void SetSink(ImGuiNodesJournalSink sink, void *user_data = nullptr)
+        {
+            sink_ = sink;
+            sink_user_data_ = user_data;
+        }
+
+        ImGuiNodesJournal() = default;
+        ImGuiNodesJournal(const ImGuiNodesJournal &) = delete;
+        ImGuiNodesJournal &operator=(const ImGuiNodesJournal &) = delete;
+        ~ImGuiNodesJournal() { Clear(); }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    struct ImGuiNodes;
+    struct ImGuiNodesSnapshotData;
+    struct ImGuiNodesSnapshotSections;
+    struct ImGuiNodesPager;
+
+    // observes model changes on the UI thread, e.g. to persist them
+    struct ImGuiNodesListener
+    {
+        // a finished step, either just done or redone (undo false) or undone (undo true), already applied to the graph,
+        // RemoveNode() reports a single Delete record that is not in the journal, the node's wires went with it
+        virtual void OnStep(const ImGuiNodes & /*nodes*/, const ImGuiNodesJournalRecord * /*records*/, size_t /*count*/, bool /*undo*/) {}
+        // batches, loads and Clear() bypass the journal, only the whole graph describes them
+        virtual void OnReset(const ImGuiNodes & /*nodes*/) {}
+        virtual void OnNodeDesc(const ImGuiNodes & /*nodes*/, const ImGuiNodesNodeDesc & /*desc*/) {}
+        // replaced by another listener or the editor is going away
+        virtual void OnDetach(const ImGuiNodes & /*nodes*/) {}
+
+        virtual ~ImGuiNodesListener() = default;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
     struct ImGuiNodes
     {
     private:
+        friend struct ImGuiNodesPager;
+
         ImVec2 mouse_;
         ImVec2 pos_;
         ImVec2 size_;
@@ -495,6 +827,18 @@ namespace ImGui
         ImVec4 connection_;
         float scale_;
         bool window_focused_;
+        bool profile_overlay_ = false;
+        bool stats_overlay_ = false;
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        ImGuiNodesStats stats_;
+        ImGuiNodesFrameArena frame_arena_;
+        ImGuiNodesAllocCounter alloc_counter_ = nullptr;
+        void *alloc_counter_user_data_ = nullptr;
+        int frame_vertices_ = 0;
+        int frame_indices_ = 0;
+        size_t frame_allocations_ = 0;
 
         ////////////////////////////////////////////////////////////////////////////////
 
@@ -511,12 +855,67 @@ namespace ImGui
         std::vector<ImGuiNodesNode *> nodes_;
         std::unordered_set<ImGuiNodesNodeDesc, ImGuiNodesNodeDesc::Hash, ImGuiNodesNodeDesc::Equal> nodes_desc_;
 
+        // node names owned by the editor, e.g. the ones read from a snapshot
+        std::vector<std::unique_ptr<char[]>> name_pool_;
+
+        // built at the start of the next Update(), the first point text can be measured
+        std::vector<ImGuiNodesBatch> batches_;
+
+        ImGuiNodesCommandQueue commands_;
+        std::unordered_map<uint32_t, ImGuiNodesNode *> command_nodes_; // by handle, only nodes in the graph
+        std::vector<ImGuiNodesNode *> command_removed_;
+        double command_budget_ = 2.0;
+
+        ImGuiNodesJournal journal_;
+        ImGuiNodesListener *listener_ = nullptr;
+        uint32_t next_node_id_ = 0;
+        uint32_t generation_ = 0;
+
+        ImGuiNodesPager *pager_ = nullptr;
+
         ////////////////////////////////////////////////////////////////////////////////
 
     private:
         void UpdateCanvasGeometry(ImDrawList *draw_list);
         ImGuiNodesNode *UpdateNodesFromCanvas();
+        void UpdateStateMachine(ImGuiNodesNode *hovered_node);
+        ImGuiNodesNode *BuildNodeFromDesc(ImGuiNodesNodeDesc *desc);
         ImGuiNodesNode *CreateNodeFromDesc(ImGuiNodesNodeDesc *desc, ImVec2 pos);
+        void BuildBatch(ImGuiNodesBatch &batch);
+
+        // returns the number of commands applied, all of them are one undo step
+        int ApplyCommands();
+        void RemoveCommandNodes();
+
+        inline ImGuiNodesNode *FindCommandNode(uint32_t handle) const
+        {
+            auto node = command_nodes_.find(handle);
+            return node != command_nodes_.end() ? node->second : NULL;
+        }
+
+        // every way out of the graph goes through here, so a handle never outlives its node
+        inline void ForgetCommandNode(ImGuiNodesNode *node)
+        {
+            if (node->handle_)
+                command_nodes_.erase(node->handle_);
+
+            node->handle_ = 0;
+        }
+
+        void SetInput(ImGuiNodesNode *input_node, size_t input_slot, ImGuiNodesNode *output_node, size_t output_slot);
+        // SetInput() recorded in the journal, a NULL output_node disconnects
+        void LinkInput(ImGuiNodesNode *input_node, size_t input_slot, ImGuiNodesNode *output_node, size_t output_slot);
+        // drops every wire from and to a node that is out of nodes_
+        void UnlinkNode(ImGuiNodesNode *node);
+        void DetachNode(ImGuiNodesNode *node);
+        void ApplyJournal(const ImGuiNodesJournalRecord *records, size_t count, bool undo);
+        static void JournalSink(void *user_data, const ImGuiNodesJournalRecord *records, size_t count);
+
+        // descs registered by the application win over the recorded ones, unknown descs are registered
+        void RegisterSnapshotDescs(const ImGuiNodesSnapshotSections &sections, std::vector<ImGuiNodesNodeDesc *> &descs);
+        void DetachPager();
+        // Clear() without telling the listener, loads call it and notify once the new graph is built
+        void Reset();
 
         inline void DrawConnection(ImVec2 p1, ImVec2 p4, ImColor color)
         {
@@ -533,7 +932,7 @@ namespace ImGui
             draw_list->AddBezierCubic(p1, p2, p3, p4, color, 1.5f * scale_);
         }
 
-        inline bool ConnectionMatrix(ImGuiNodesNode *input_node, ImGuiNodesNode *output_node, ImGuiNodesInput *input, ImGuiNodesOutput *output)
+        inline bool ConnectionMatrix(ImGuiNodesNode * /*input_node*/, ImGuiNodesNode *output_node, ImGuiNodesInput *input, ImGuiNodesOutput *output)
         {
             if (input->target_ && input->target_ == output_node)
                 return false;
@@ -552,6 +951,12 @@ namespace ImGui
 
         inline bool SortSelectedNodesOrder();
 
+        void DrawWires(const ImRect &clip, ImVec2 offset);
+        void DrawNodes(ImDrawList *draw_list, ImVec2 offset);
+        void DrawStatsOverlay(ImDrawList *draw_list, ImVec2 pos);
+
+        inline size_t CountAllocations() const { return alloc_counter_ ? alloc_counter_(alloc_counter_user_data_) : 0; }
+
     public:
         void Update();
         void ProcessNodes();
@@ -559,12 +964,89 @@ namespace ImGui
 
         void AddNodeDesc(ImGuiNodesNodeDesc &&desc);
 
+        ImGuiNodesNodeDesc *FindNodeDesc(const std::string_view &desc_name);
+
         ImGuiNodesNode *AddNode(const std::string_view &desc_name, ImVec2 pos = {});
+        // hands the node back to the caller without its wires, the undo history forgets only this node
         void RemoveNode(ImGuiNodesNode *node);
+        // moves the top left corners of the nodes as one undo step, e.g. for layouts
+        void MoveNodes(ImGuiNodesNode *const *nodes, const ImVec2 *positions, size_t count);
+
+        // also bound to Ctrl+Z and Ctrl+Y / Ctrl+Shift+Z, false when there is nothing to apply
+        bool Undo();
+        bool Redo();
+        bool CanUndo() const { return journal_.CanUndo(); }
+        bool CanRedo() const { return journal_.CanRedo(); }
+        void ClearUndo() { journal_.Clear(); }
+
+        // bytes of undo history kept before the oldest steps are dropped, 0 keeps none
+        void SetUndoBudget(size_t bytes) { journal_.SetBudget(bytes); }
+        size_t GetUndoBytes() const { return journal_.GetBytes(); }
+
+        // bulk construction for large graphs: descs are resolved once by the caller, connections skip
+        // IsConnection() and text is measured once per desc when the batch is built by the next Update(),
+        // until then GetNodes() and the savers do not see its nodes
+        void AddBatch(ImGuiNodesBatch &&batch);
+        // builds pending batches right away, needs a frame like AddNode()
+        void FlushBatches();
+
+        // for producer threads, the commands are applied at the start of Update() for at most the budget
+        // in milliseconds per frame, 0 applies all of them, Clear() and loads drop the handles
+        ImGuiNodesCommandQueue &GetCommandQueue() { return commands_; }
+        void SetCommandBudget(double milliseconds) { command_budget_ = milliseconds; }
+        double GetCommandBudget() const { return command_budget_; }
 
         void Clear();
 
+        // flat binary snapshot of descs, nodes, names and connections, see ImGuiNodesSnapshot.h
+        // loading replaces the whole graph and measures text, so call it inside a frame like AddNode()
+        bool SaveSnapshot(const char *path) const;
+        bool LoadSnapshot(const char *path);
+        // in memory variants, gathering does no I/O so the data can be written by another thread
+        bool SaveSnapshot(ImGuiNodesSnapshotData &data) const;
+        bool LoadSnapshot(const ImGuiNodesSnapshotSections &sections);
+
+        // streamed JSON for interchange with other tools, see ImGuiNodesJson.h for the layout
+        // importing replaces the whole graph only once the document parsed, same frame rule as LoadSnapshot()
+        bool ExportJson(const char *path) const;
+        bool ImportJson(const char *path);
+
         ImGuiNodesNode *GetProcessingNode() const { return processing_node_; }
+        // the node held by the mouse while nodes are dragged, the selected nodes move along with it
+        ImGuiNodesNode *GetDraggedNode() const { return state_ == ImGuiNodesState_Draging ? element_node_ : NULL; }
+        const std::vector<ImGuiNodesNode *> &GetNodes() const { return nodes_; }
+        // bumped by Clear() and loads, node ids and pointers seen before then may name other nodes now
+        uint32_t GetGeneration() const { return generation_; }
+
+        // one listener at a time, NULL detaches it
+        void SetListener(ImGuiNodesListener *listener);
+        ImGuiNodesListener *GetListener() const { return listener_; }
+
+        // set by ImGuiNodesPager::Open() until the pager is closed or the graph is cleared
+        ImGuiNodesPager *GetPager() const { return pager_; }
+
+        ImVec2 GetScroll() const { return scroll_; }
+        float GetScale() const { return scale_; }
+        void SetScroll(ImVec2 scroll) { scroll_ = scroll; }
+        void SetScale(float scale) { scale_ = ImClamp(scale, 0.3f, 3.0f); }
+
+        void SetProfileOverlay(bool enabled) { profile_overlay_ = enabled; }
+        bool GetProfileOverlay() const { return profile_overlay_; }
+
+        const ImGuiNodesStats &GetStats() const { return stats_; }
+
+        void SetStatsOverlay(bool enabled) { stats_overlay_ = enabled; }
+        bool GetStatsOverlay() const { return stats_overlay_; }
+
+        void SetAllocCounter(ImGuiNodesAllocCounter counter, void *user_data = nullptr)
+        {
+            alloc_counter_ = counter;
+            alloc_counter_user_data_ = user_data;
+        }
+
+        // most expensive first, by accumulated kernel time
+        void GetNodesByCost(std::vector<ImGuiNodesNode *> &nodes) const;
+        void ResetProfile();
 
         bool IsConnection(ImGuiNodesNode *output_node, size_t output_slot, ImGuiNodesNode *input_node, size_t input_slot);
         bool IsConnection(ImGuiNodesNode *output_node, ImGuiNodesNode *input_node);
@@ -663,6 +1145,9 @@ namespace ImGui
 
         ~ImGuiNodes()
         {
+            SetListener(nullptr);
+            DetachPager();
+
             for (int node_idx = 0; node_idx < nodes_.size(); ++node_idx)
                 delete nodes_[node_idx];
         }
@@ -678,6 +1163,11 @@ namespace ImGui
 
 #if defined(IMGUI_NODES_HEADER_ONLY)
 #include "ImGuiNodes.cc"
+#include "ImGuiNodesJson.h"
+#include "ImGuiNodesSnapshot.h"
+#include "ImGuiNodesAutosave.h"
+#include "ImGuiNodesPager.h"
+#include "ImGuiNodesLayout.h"
 #endif
 
 #endif // !IMGUI_NODES_H
\ No newline at end of file
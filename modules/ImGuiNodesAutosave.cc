@@ -0,0 +1,608 @@
+#include "ImGuiNodesAutosave.h"
+
+#include <string.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace ImGui
+{
+    static uint32_t HashWalRecord(const unsigned char *data, size_t size)
+    {
+        uint32_t hash = 2166136261u;
+
+        for (size_t byte_idx = 0; byte_idx < size; ++byte_idx)
+            hash = (hash ^ data[byte_idx]) * 16777619u;
+
+        return hash;
+    }
+
+    static void SyncWalFile(FILE *file)
+    {
+#if defined(_WIN32)
+        _commit(_fileno(file));
+#else
+        fsync(fileno(file));
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void ImGuiNodesAutosave::Encode(uint32_t op, uint32_t node, const void *payload, size_t size, const char *name)
+    {
+        const size_t name_size = name ? strlen(name) + 1 : 0;
+
+        ImGuiNodesWalRecord record;
+        record.size_ = static_cast<uint32_t>(sizeof(record) + size + name_size);
+        record.check_ = 0;
+        record.op_ = op;
+        record.node_ = node;
+
+        const size_t offset = scratch_.size();
+        scratch_.resize(offset + record.size_);
+
+        unsigned char *data = scratch_.data() + offset;
+        memcpy(data, &record, sizeof(record));
+        if (size)
+            memcpy(data + sizeof(record), payload, size);
+        if (name_size)
+            memcpy(data + sizeof(record) + size, name, name_size);
+
+        record.check_ = HashWalRecord(data + offsetof(ImGuiNodesWalRecord, op_), record.size_ - offsetof(ImGuiNodesWalRecord, op_));
+        memcpy(data + offsetof(ImGuiNodesWalRecord, check_), &record.check_, sizeof(record.check_));
+    }
+
+    void ImGuiNodesAutosave::EncodeNode(const ImGuiNodesNode *node)
+    {
+        ImGuiNodesWalAdd add{};
+        add.pos_ = node->area_node_.Min;
+        add.state_ = node->state_ & ImGuiNodesSnapshotNodeStateMask;
+        memcpy(add.desc_, node->desc_->name_, sizeof(add.desc_));
+
+        Encode(ImGuiNodesWalOp_Add, node->id_, &add, sizeof(add), node->name_ != node->desc_->name_ ? node->name_ : "");
+    }
+
+    void ImGuiNodesAutosave::Submit()
+    {
+        if (scratch_.empty())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.insert(pending_.end(), scratch_.begin(), scratch_.end());
+        }
+
+        scratch_.clear();
+        wake_.notify_one();
+    }
+
+    void ImGuiNodesAutosave::OnStep(const ImGuiNodes & /*nodes*/, const ImGuiNodesJournalRecord *records, size_t count, bool undo)
+    {
+        for (size_t step_idx = 0; step_idx < count; ++step_idx)
+        {
+            const ImGuiNodesJournalRecord &record = records[undo ? count - step_idx - 1 : step_idx];
+            const ImGuiNodesNode *node = record.node_;
+
+            switch (record.op_)
+            {
+            case ImGuiNodesJournalOp_Translate:
+            case ImGuiNodesJournalOp_Collapse:
+            case ImGuiNodesJournalOp_Disable:
+            {
+                ImGuiNodesWalMove move{};
+                move.pos_ = node->area_node_.Min;
+                move.state_ = node->state_ & ImGuiNodesSnapshotNodeStateMask;
+
+                Encode(ImGuiNodesWalOp_Move, node->id_, &move, sizeof(move));
+                break;
+            }
+
+            case ImGuiNodesJournalOp_Link:
+            {
+                const ImGuiNodesNode *output_node = record.outputs_[undo ? 0 : 1];
+
+                ImGuiNodesWalLink link{};
+                link.slot_ = record.slot_;
+                link.output_node_ = output_node ? output_node->id_ : 0;
+                link.output_slot_ = record.output_slots_[undo ? 0 : 1];
+
+                Encode(ImGuiNodesWalOp_Link, node->id_, &link, sizeof(link));
+                break;
+            }
+
+            case ImGuiNodesJournalOp_Create:
+            case ImGuiNodesJournalOp_Delete:
+            {
+                if (undo == (record.op_ == ImGuiNodesJournalOp_Delete))
+                    EncodeNode(node);
+                else
+                    Encode(ImGuiNodesWalOp_Delete, node->id_, nullptr, 0);
+
+                break;
+            }
+            }
+        }
+
+        Submit();
+    }
+
+    void ImGuiNodesAutosave::OnReset(const ImGuiNodes &nodes)
+    {
+        // gathering is a copy of the graph, the writer does the I/O
+        std::unique_ptr<ImGuiNodesSnapshotData> checkpoint = std::make_unique<ImGuiNodesSnapshotData>();
+        if (!nodes.SaveSnapshot(*checkpoint))
+        {
+            failed_ = true;
+            return;
+        }
+
+        scratch_.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            checkpoint_ = std::move(checkpoint);
+            pending_.clear();
+        }
+
+        wake_.notify_one();
+    }
+
+    void ImGuiNodesAutosave::OnNodeDesc(const ImGuiNodes & /*nodes*/, const ImGuiNodesNodeDesc &desc)
+    {
+        std::vector<unsigned char> payload(sizeof(ImGuiNodesSnapshotDesc) + (desc.inputs_.size() + desc.outputs_.size()) * sizeof(ImGuiNodesConnectionDesc));
+
+        ImGuiNodesSnapshotDesc record{};
+        memcpy(record.name_, desc.name_, sizeof(record.name_));
+        record.type_ = desc.type_;
+        record.color_ = desc.color_.Value;
+        record.input_count_ = static_cast<uint32_t>(desc.inputs_.size());
+        record.output_count_ = static_cast<uint32_t>(desc.outputs_.size());
+
+        unsigned char *data = payload.data();
+        memcpy(data, &record, sizeof(record));
+        data += sizeof(record);
+
+        if (!desc.inputs_.empty())
+            memcpy(data, desc.inputs_.data(), desc.inputs_.size() * sizeof(ImGuiNodesConnectionDesc));
+
+        data += desc.inputs_.size() * sizeof(ImGuiNodesConnectionDesc);
+
+        if (!desc.outputs_.empty())
+            memcpy(data, desc.outputs_.data(), desc.outputs_.size() * sizeof(ImGuiNodesConnectionDesc));
+
+        Encode(ImGuiNodesWalOp_Desc, 0, payload.data(), payload.size());
+        Submit();
+    }
+
+    void ImGuiNodesAutosave::OnDetach(const ImGuiNodes & /*nodes*/)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+
+        wake_.notify_one();
+
+        if (thread_.joinable())
+            thread_.join();
+
+        if (log_)
+            fclose(log_);
+
+        log_ = nullptr;
+        nodes_ = nullptr;
+        stop_ = false;
+        pending_.clear();
+        checkpoint_.reset();
+        scratch_.clear();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    bool ImGuiNodesAutosave::Start(ImGuiNodes &nodes, const char *path)
+    {
+        Stop();
+
+        std::unique_ptr<ImGuiNodesSnapshotData> checkpoint = std::make_unique<ImGuiNodesSnapshotData>();
+        if (!nodes.SaveSnapshot(*checkpoint))
+            return false;
+
+        nodes_ = &nodes;
+        path_ = path;
+        log_path_ = path_ + ".wal";
+        failed_ = false;
+        checkpoint_ = std::move(checkpoint);
+
+        thread_ = std::thread(&ImGuiNodesAutosave::Run, this);
+        nodes.SetListener(this);
+
+        return true;
+    }
+
+    void ImGuiNodesAutosave::Stop()
+    {
+        if (nodes_)
+            nodes_->SetListener(nullptr);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void ImGuiNodesAutosave::Run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        while (true)
+        {
+            wake_.wait(lock, [this]
+                       { return stop_ || checkpoint_ || !pending_.empty(); });
+
+            // give the UI a moment to queue more records so they share one fsync
+            if (!stop_ && !checkpoint_)
+                wake_.wait_for(lock, std::chrono::milliseconds(SyncInterval), [this]
+                               { return stop_ || checkpoint_ || pending_.size() >= FlushSize; });
+
+            std::unique_ptr<ImGuiNodesSnapshotData> checkpoint = std::move(checkpoint_);
+            writing_.swap(pending_);
+            const bool stop = stop_;
+
+            lock.unlock();
+
+            bool succeed = true;
+
+            if (checkpoint)
+                succeed = WriteCheckpoint(*checkpoint);
+
+            if (succeed && !writing_.empty())
+                succeed = AppendLog(writing_);
+
+            if (succeed && log_size_ >= compact_size_)
+                succeed = Compact();
+
+            if (!succeed)
+                failed_ = true;
+
+            writing_.clear();
+
+            lock.lock();
+
+            if (stop && !checkpoint_ && pending_.empty())
+                break;
+        }
+    }
+
+    bool ImGuiNodesAutosave::WriteCheckpoint(const ImGuiNodesSnapshotData &data)
+    {
+        // the snapshot is replaced whole, a crash leaves either the old one with its log or the new one
+        const std::string temporary = path_ + ".tmp";
+
+        if (!data.Write(temporary.c_str(), true))
+            return false;
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path_, error);
+        if (error)
+            return false;
+
+        return ResetLog();
+    }
+
+    bool ImGuiNodesAutosave::ResetLog()
+    {
+        if (log_)
+            fclose(log_);
+
+        log_ = fopen(log_path_.c_str(), "wb");
+        log_size_ = 0;
+
+        if (nullptr == log_)
+            return false;
+
+        ImGuiNodesWalHeader header{};
+        memcpy(header.magic_, ImGuiNodesWalMagic, sizeof(header.magic_));
+        header.version_ = ImGuiNodesWalVersion;
+        header.byte_order_ = ImGuiNodesSnapshotByteOrder;
+
+        if (1 != fwrite(&header, sizeof(header), 1, log_) || 0 != fflush(log_))
+            return false;
+
+        SyncWalFile(log_);
+        return true;
+    }
+
+    bool ImGuiNodesAutosave::AppendLog(const std::vector<unsigned char> &records)
+    {
+        if (nullptr == log_)
+            return false;
+
+        if (records.size() != fwrite(records.data(), 1, records.size(), log_) || 0 != fflush(log_))
+            return false;
+
+        SyncWalFile(log_);
+        log_size_ += records.size();
+        return true;
+    }
+
+    bool ImGuiNodesAutosave::Compact()
+    {
+        // closed while it is read back, Windows would not share it with the mapping otherwise
+        fclose(log_);
+        log_ = nullptr;
+
+        ImGuiNodesSnapshotData data;
+        bool succeed = data.Read(path_.c_str()) && Replay(log_path_.c_str(), data) && WriteCheckpoint(data);
+
+        if (nullptr == log_)
+        {
+            log_ = fopen(log_path_.c_str(), "ab");
+            log_size_ = 0;
+        }
+
+        return succeed && log_;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    bool ImGuiNodesAutosave::Replay(const char *log_path, ImGuiNodesSnapshotData &data)
+    {
+        ImGuiNodesMappedFile file;
+        if (!file.Open(log_path))
+            return true; // no log yet, or an empty one
+
+        const unsigned char *bytes = file.GetData();
+        const size_t size = file.GetSize();
+
+        ImGuiNodesWalHeader header;
+        if (size < sizeof(header))
+            return true;
+
+        memcpy(&header, bytes, sizeof(header));
+
+        if (0 != memcmp(header.magic_, ImGuiNodesWalMagic, sizeof(header.magic_)))
+            return false;
+
+        if (header.version_ != ImGuiNodesWalVersion || header.byte_order_ != ImGuiNodesSnapshotByteOrder)
+            return false;
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        constexpr uint32_t removed = UINT32_MAX;
+
+        std::unordered_map<std::string, uint32_t> desc_indices;
+        std::unordered_map<uint32_t, uint32_t> node_indices;
+        std::unordered_map<uint64_t, uint32_t> edge_indices; // input node index and slot
+
+        desc_indices.reserve(data.descs_.size());
+        node_indices.reserve(data.nodes_.size());
+        edge_indices.reserve(data.edges_.size());
+
+        for (size_t desc_idx = 0; desc_idx < data.descs_.size(); ++desc_idx)
+            desc_indices.emplace(data.descs_[desc_idx].name_, static_cast<uint32_t>(desc_idx));
+
+        for (size_t node_idx = 0; node_idx < data.nodes_.size(); ++node_idx)
+            if (data.nodes_[node_idx].id_)
+                node_indices.emplace(data.nodes_[node_idx].id_, static_cast<uint32_t>(node_idx));
+
+        for (size_t edge_idx = 0; edge_idx < data.edges_.size(); ++edge_idx)
+        {
+            const ImGuiNodesEdge &edge = data.edges_[edge_idx];
+            edge_indices[(uint64_t(edge.input_node_) << 32) | edge.input_slot_] = static_cast<uint32_t>(edge_idx);
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        for (size_t offset = sizeof(header); offset + sizeof(ImGuiNodesWalRecord) <= size;)
+        {
+            ImGuiNodesWalRecord record;
+            memcpy(&record, bytes + offset, sizeof(record));
+
+            if (record.size_ < sizeof(record) || record.size_ > size - offset)
+                break;
+
+            if (record.check_ != HashWalRecord(bytes + offset + offsetof(ImGuiNodesWalRecord, op_), record.size_ - offsetof(ImGuiNodesWalRecord, op_)))
+                break;
+
+            const unsigned char *payload = bytes + offset + sizeof(record);
+            const size_t payload_size = record.size_ - sizeof(record);
+
+            offset += record.size_;
+
+            auto node = node_indices.find(record.node_);
+
+            switch (record.op_)
+            {
+            case ImGuiNodesWalOp_Desc:
+            {
+                ImGuiNodesSnapshotDesc desc;
+                if (payload_size < sizeof(desc))
+                    return false;
+
+                memcpy(&desc, payload, sizeof(desc));
+
+                const size_t connector_count = size_t(desc.input_count_) + desc.output_count_;
+                if (payload_size != sizeof(desc) + connector_count * sizeof(ImGuiNodesConnectionDesc) || nullptr == memchr(desc.name_, '\0', sizeof(desc.name_)))
+                    return false;
+
+                if (desc_indices.count(desc.name_))
+                    break;
+
+                desc.first_connector_ = static_cast<uint32_t>(data.connectors_.size());
+                data.connectors_.resize(data.connectors_.size() + connector_count);
+                memcpy(data.connectors_.data() + desc.first_connector_, payload + sizeof(desc), connector_count * sizeof(ImGuiNodesConnectionDesc));
+
+                desc_indices.emplace(desc.name_, static_cast<uint32_t>(data.descs_.size()));
+                data.descs_.push_back(desc);
+                break;
+            }
+
+            case ImGuiNodesWalOp_Add:
+            {
+                ImGuiNodesWalAdd add;
+                if (payload_size <= sizeof(add) || '\0' != payload[payload_size - 1])
+                    return false;
+
+                memcpy(&add, payload, sizeof(add));
+                if (nullptr == memchr(add.desc_, '\0', sizeof(add.desc_)))
+                    return false;
+
+                auto desc = desc_indices.find(add.desc_);
+                if (desc == desc_indices.end() || 0 == record.node_)
+                    break;
+
+                ImGuiNodesSnapshotNode snapshot_node{};
+                snapshot_node.pos_ = add.pos_;
+                snapshot_node.desc_ = desc->second;
+                snapshot_node.state_ = add.state_ & ImGuiNodesSnapshotNodeStateMask;
+                snapshot_node.id_ = record.node_;
+
+                const char *name = reinterpret_cast<const char *>(payload + sizeof(add));
+                if ('\0' != name[0])
+                {
+                    snapshot_node.name_ = static_cast<uint32_t>(data.names_.size() + 1);
+                    data.names_.insert(data.names_.end(), name, name + strlen(name) + 1);
+                }
+
+                if (node != node_indices.end())
+                    data.nodes_[node->second] = snapshot_node;
+                else
+                {
+                    node_indices.emplace(record.node_, static_cast<uint32_t>(data.nodes_.size()));
+                    data.nodes_.push_back(snapshot_node);
+                }
+
+                break;
+            }
+
+            case ImGuiNodesWalOp_Move:
+            {
+                ImGuiNodesWalMove move;
+                if (payload_size != sizeof(move))
+                    return false;
+
+                memcpy(&move, payload, sizeof(move));
+
+                if (node != node_indices.end())
+                {
+                    data.nodes_[node->second].pos_ = move.pos_;
+                    data.nodes_[node->second].state_ = move.state_ & ImGuiNodesSnapshotNodeStateMask;
+                }
+
+                break;
+            }
+
+            case ImGuiNodesWalOp_Delete:
+            {
+                // its edges go when the data is compacted below
+                if (node != node_indices.end())
+                {
+                    data.nodes_[node->second].desc_ = removed;
+                    node_indices.erase(node);
+                }
+
+                break;
+            }
+
+            case ImGuiNodesWalOp_Link:
+            {
+                ImGuiNodesWalLink link;
+                if (payload_size != sizeof(link))
+                    return false;
+
+                memcpy(&link, payload, sizeof(link));
+
+                if (node == node_indices.end() || link.slot_ >= data.descs_[data.nodes_[node->second].desc_].input_count_)
+                    break;
+
+                const uint64_t key = (uint64_t(node->second) << 32) | link.slot_;
+                auto edge = edge_indices.find(key);
+
+                auto output = node_indices.find(link.output_node_);
+                if (0 == link.output_node_ || output == node_indices.end() || link.output_slot_ >= data.descs_[data.nodes_[output->second].desc_].output_count_)
+                {
+                    if (edge != edge_indices.end())
+                    {
+                        data.edges_[edge->second].output_node_ = removed;
+                        edge_indices.erase(edge);
+                    }
+
+                    break;
+                }
+
+                const ImGuiNodesEdge connection = {output->second, link.output_slot_, node->second, link.slot_};
+
+                if (edge != edge_indices.end())
+                    data.edges_[edge->second] = connection;
+                else
+                {
+                    edge_indices.emplace(key, static_cast<uint32_t>(data.edges_.size()));
+                    data.edges_.push_back(connection);
+                }
+
+                break;
+            }
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        // drop removed nodes and edges, names are rebuilt so replaced ones do not pile up
+        std::vector<uint32_t> remap(data.nodes_.size(), removed);
+        std::vector<char> names;
+        size_t kept_count = 0;
+
+        for (size_t node_idx = 0; node_idx < data.nodes_.size(); ++node_idx)
+        {
+            ImGuiNodesSnapshotNode snapshot_node = data.nodes_[node_idx];
+            if (removed == snapshot_node.desc_)
+                continue;
+
+            if (snapshot_node.name_)
+            {
+                const char *name = data.names_.data() + snapshot_node.name_ - 1;
+                snapshot_node.name_ = static_cast<uint32_t>(names.size() + 1);
+                names.insert(names.end(), name, name + strlen(name) + 1);
+            }
+
+            remap[node_idx] = static_cast<uint32_t>(kept_count);
+            data.nodes_[kept_count++] = snapshot_node;
+        }
+
+        data.nodes_.resize(kept_count);
+        data.names_.swap(names);
+
+        size_t edge_count = 0;
+
+        for (ImGuiNodesEdge edge : data.edges_)
+        {
+            if (removed == edge.output_node_ || removed == remap[edge.output_node_] || removed == remap[edge.input_node_])
+                continue;
+
+            edge.output_node_ = remap[edge.output_node_];
+            edge.input_node_ = remap[edge.input_node_];
+            data.edges_[edge_count++] = edge;
+        }
+
+        data.edges_.resize(edge_count);
+
+        return true;
+    }
+
+    bool ImGuiNodesAutosave::Recover(ImGuiNodes &nodes, const char *path)
+    {
+        ImGuiNodesSnapshotData data;
+        if (!data.Read(path))
+            return false;
+
+        if (!Replay((std::string(path) + ".wal").c_str(), data))
+            return false;
+
+        return nodes.LoadSnapshot(data.GetSections());
+    }
+}
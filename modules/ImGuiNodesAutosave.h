@@ -0,0 +1,153 @@
+#ifndef IMGUI_NODES_AUTOSAVE_H // !IMGUI_NODES_AUTOSAVE_H
+#define IMGUI_NODES_AUTOSAVE_H
+
+#include "ImGuiNodes.h"
+#include "ImGuiNodesSnapshot.h"
+
+#include <stdio.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ImGui
+{
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // write-ahead log kept next to the autosave snapshot as "<path>.wal", host byte order:
+    // ImGuiNodesWalHeader, then records until the end of the file or the first one failing its check
+    // records carry absolute state, replaying a log over a snapshot that already holds part of it is harmless
+    constexpr char ImGuiNodesWalMagic[8] = {'I', 'G', 'N', 'W', 'A', 'L', '\0', '\0'};
+    constexpr uint32_t ImGuiNodesWalVersion = 1;
+
+    enum ImGuiNodesWalOp_
+    {
+        ImGuiNodesWalOp_Desc = 1, // ImGuiNodesSnapshotDesc then its inputs and outputs as ImGuiNodesConnectionDesc
+        ImGuiNodesWalOp_Add,      // ImGuiNodesWalAdd then the NUL terminated node name, empty keeps the desc name
+        ImGuiNodesWalOp_Move,     // ImGuiNodesWalMove
+        ImGuiNodesWalOp_Delete,
+        ImGuiNodesWalOp_Link // ImGuiNodesWalLink
+    };
+
+    struct ImGuiNodesWalHeader
+    {
+        char magic_[8];
+        uint32_t version_;
+        uint32_t byte_order_;
+    };
+
+    // size_ counts the whole record, check_ hashes everything after itself
+    struct ImGuiNodesWalRecord
+    {
+        uint32_t size_;
+        uint32_t check_;
+        uint32_t op_;
+        uint32_t node_; // ImGuiNodesNode::id_
+    };
+
+    // positions are the top left corner like in snapshots, states are masked by ImGuiNodesSnapshotNodeStateMask
+    struct ImGuiNodesWalAdd
+    {
+        ImVec2 pos_;
+        uint32_t state_;
+        char desc_[ImGuiNodesNamesMaxLen];
+    };
+
+    struct ImGuiNodesWalMove
+    {
+        ImVec2 pos_;
+        uint32_t state_;
+    };
+
+    // input slot_ of the record node, output_node_ zero disconnects it
+    struct ImGuiNodesWalLink
+    {
+        uint32_t slot_;
+        uint32_t output_node_;
+        uint32_t output_slot_;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // follows an editor and persists every change, the UI thread only encodes records and queues them,
+    // a writer thread appends them to the log with one fsync per batch and folds the log into the snapshot
+    struct ImGuiNodesAutosave : ImGuiNodesListener
+    {
+    public:
+        static constexpr int SyncInterval = 250;    // milliseconds a record may wait for others to share its fsync
+        static constexpr size_t FlushSize = 1 << 20; // pending bytes that are written without waiting
+
+    private:
+        ImGuiNodes *nodes_ = nullptr;
+        std::string path_;
+        std::string log_path_;
+        size_t compact_size_ = 16 << 20;
+
+        std::thread thread_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::vector<unsigned char> pending_;
+        std::unique_ptr<ImGuiNodesSnapshotData> checkpoint_; // supersedes the snapshot, the log and everything pending
+        bool stop_ = false;
+        std::atomic<bool> failed_ = false;
+
+        // UI thread
+        std::vector<unsigned char> scratch_;
+
+        // writer thread
+        std::vector<unsigned char> writing_;
+        FILE *log_ = nullptr;
+        uint64_t log_size_ = 0;
+
+        void Run();
+        bool WriteCheckpoint(const ImGuiNodesSnapshotData &data);
+        bool ResetLog();
+        bool AppendLog(const std::vector<unsigned char> &records);
+        bool Compact();
+
+        void Encode(uint32_t op, uint32_t node, const void *payload, size_t size, const char *name = nullptr);
+        void EncodeNode(const ImGuiNodesNode *node);
+        void Submit();
+
+    public:
+        // queues a checkpoint of the current graph and follows it from now on, Recover() the same path after a crash
+        bool Start(ImGuiNodes &nodes, const char *path);
+        // writes out everything queued and detaches from the editor
+        void Stop();
+
+        bool IsRunning() const { return nodes_ != nullptr; }
+        // a write failed, autosave keeps trying but the files may be behind
+        bool IsFailed() const { return failed_; }
+
+        // log size that makes the writer fold the log into the snapshot, set before Start()
+        void SetCompactSize(size_t bytes) { compact_size_ = bytes; }
+
+        // applies the records of a log to the snapshot data, a torn or corrupt tail ends the replay
+        static bool Replay(const char *log_path, ImGuiNodesSnapshotData &data);
+        // loads the snapshot plus its log, measures text so call it inside a frame like LoadSnapshot()
+        static bool Recover(ImGuiNodes &nodes, const char *path);
+
+        void OnStep(const ImGuiNodes &nodes, const ImGuiNodesJournalRecord *records, size_t count, bool undo) override;
+        void OnReset(const ImGuiNodes &nodes) override;
+        void OnNodeDesc(const ImGuiNodes &nodes, const ImGuiNodesNodeDesc &desc) override;
+        void OnDetach(const ImGuiNodes &nodes) override;
+
+        ImGuiNodesAutosave() = default;
+        ImGuiNodesAutosave(const ImGuiNodesAutosave &) = delete;
+        ImGuiNodesAutosave &operator=(const ImGuiNodesAutosave &) = delete;
+        ~ImGuiNodesAutosave() { Stop(); }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+}
+
+#if defined(IMGUI_NODES_HEADER_ONLY)
+#include "ImGuiNodesAutosave.cc"
+#endif
+
+#endif // !IMGUI_NODES_AUTOSAVE_H
@@ -0,0 +1,766 @@
+#include "ImGuiNodesExecutor.h"
+
+#include <algorithm>
+
+namespace ImGui
+{
+    bool ImGuiNodesChunkQueue::Push(std::string &&chunk)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        writable_.wait(lock, [this]
+                       { return closed_ || chunks_.size() < capacity_; });
+
+        if (closed_)
+            return false;
+
+        chunks_.push_back(std::move(chunk));
+        readable_.notify_one();
+        return true;
+    }
+
+    bool ImGuiNodesChunkQueue::Pop(std::string &chunk)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        readable_.wait(lock, [this]
+                       { return closed_ || !chunks_.empty(); });
+
+        if (chunks_.empty())
+            return false;
+
+        chunk = std::move(chunks_.front());
+        chunks_.pop_front();
+        writable_.notify_one();
+        return true;
+    }
+
+    void ImGuiNodesChunkQueue::Close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        closed_ = true;
+        readable_.notify_all();
+        writable_.notify_all();
+    }
+
+    bool ImGuiNodesStreamContext::Read(size_t slot, std::string &chunk)
+    {
+        if (!IsConnected(slot))
+            return false;
+
+        auto start = std::chrono::steady_clock::now();
+        bool read = inputs_[slot]->Pop(chunk);
+        blocked_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        return read;
+    }
+
+    bool ImGuiNodesStreamContext::Write(size_t slot, std::string_view chunk)
+    {
+        if (slot >= outputs_.size())
+            return false;
+
+        bool accepted = false;
+        auto start = std::chrono::steady_clock::now();
+
+        for (const auto &queue : outputs_[slot])
+            accepted |= queue->Push(std::string(chunk));
+
+        blocked_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        written_ += chunk.size();
+
+        return accepted;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void ImGuiNodesExecutor::WorkerLoop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        for (;;)
+        {
+            condition_.wait(lock, [this]
+                            { return quit_ || !ready_.empty(); });
+
+            if (quit_)
+                return;
+
+            StepRef ref = std::move(ready_.front());
+            ready_.pop_front();
+
+            Job &job = *ref.first;
+            Step &step = job.steps_[ref.second];
+
+            if (job.cancelled_)
+                continue;
+
+            ////////////////////////////////////////////////////////////////////////////////
+
+            lock.unlock();
+
+            auto start = std::chrono::steady_clock::now();
+
+            if (!step.task_.handle_)
+                step.task_ = step.kernel_(step.context_);
+
+            bool done = step.task_.Resume();
+
+            step.time_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            lock.lock();
+
+            ////////////////////////////////////////////////////////////////////////////////
+
+            if (job.cancelled_)
+                continue;
+
+            if (done)
+                FinishStep(ref.first, ref.second);
+            else
+                ready_.push_back(std::move(ref));
+        }
+    }
+
+    bool ImGuiNodesExecutor::PrepareStep(const std::shared_ptr<Job> &job, size_t step_idx)
+    {
+        Step &step = job->steps_[step_idx];
+
+        for (size_t input_idx = 0; input_idx < step.sources_.size(); ++input_idx)
+        {
+            const auto &[source_idx, slot] = step.sources_[input_idx];
+
+            if (source_idx < job->steps_.size())
+            {
+                step.context_.inputs_[input_idx] = job->steps_[source_idx].results_[slot];
+                step.key_.push_back(job->steps_[source_idx].hashes_[slot]);
+            }
+            else
+                step.key_.push_back(0);
+        }
+
+        if (step.skipped_ || LookupCache(step))
+            return false;
+
+        ready_.emplace_back(job, step_idx);
+        condition_.notify_one();
+        return true;
+    }
+
+    void ImGuiNodesExecutor::FinishStep(const std::shared_ptr<Job> &job, size_t step_idx)
+    {
+        // skipped steps finish inline, a worklist keeps long chains of them off the call stack
+        std::vector<size_t> finishing(1, step_idx);
+
+        while (!finishing.empty())
+        {
+            Step &step = job->steps_[finishing.back()];
+
+            finished_.emplace_back(job, finishing.back());
+            finishing.pop_back();
+
+            if (!step.skipped_ && !step.cached_ && !step.task_.Failed())
+            {
+                for (size_t output_idx = 0; output_idx < step.results_.size(); ++output_idx)
+                {
+                    step.results_[output_idx] = std::make_shared<const ImGuiNodesValue>(std::move(step.context_.outputs_[output_idx]));
+                    step.hashes_[output_idx] = step.results_[output_idx]->Hash();
+                    step.bytes_ += step.results_[output_idx]->data_.size();
+                }
+
+                InsertCache(step);
+            }
+
+            step.task_ = {};
+            step.kernel_ = nullptr;
+            step.context_.inputs_.clear();
+            step.context_.outputs_.clear();
+
+            job->remaining_--;
+
+            for (size_t successor_idx : step.successors_)
+                if (--job->steps_[successor_idx].pending_ == 0 && !PrepareStep(job, successor_idx))
+                    finishing.push_back(successor_idx);
+        }
+    }
+
+    void ImGuiNodesExecutor::SortUpstream(const std::vector<ImGuiNodesNode *> &graph, ImGuiNodesNode *node, std::vector<ImGuiNodesNode *> &ordered, std::unordered_map<const ImGuiNodesNode *, size_t> &order)
+    {
+        // upstream first ordering without recursion, links back into a node being visited are cycles and get dropped
+        constexpr size_t visiting = SIZE_MAX;
+
+        std::vector<std::pair<ImGuiNodesNode *, size_t>> stack;
+
+        for (size_t root_idx = 0; root_idx < (node ? 1 : graph.size()); ++root_idx)
+        {
+            ImGuiNodesNode *root = node ? node : graph[root_idx];
+
+            if (!order.emplace(root, visiting).second)
+                continue;
+
+            stack.emplace_back(root, 0);
+
+            while (!stack.empty())
+            {
+                ImGuiNodesNode *current = stack.back().first;
+                size_t input_idx = stack.back().second++;
+
+                if (input_idx < current->inputs_.size())
+                {
+                    ImGuiNodesNode *target = current->inputs_[input_idx].target_;
+
+                    if (target && order.emplace(target, visiting).second)
+                        stack.emplace_back(target, 0);
+
+                    continue;
+                }
+
+                order[current] = ordered.size();
+                ordered.push_back(current);
+                stack.pop_back();
+            }
+        }
+    }
+
+    bool ImGuiNodesExecutor::IsCacheEntryOf(const CacheEntry &entry, const Step &step)
+    {
+        if (entry.desc_name_ != step.desc_name_ || entry.inputs_.size() != step.context_.inputs_.size())
+            return false;
+
+        for (size_t input_idx = 0; input_idx < entry.inputs_.size(); ++input_idx)
+        {
+            const ImGuiNodesValue *cached = entry.inputs_[input_idx].get();
+            const ImGuiNodesValue *input = step.context_.inputs_[input_idx].get();
+
+            if (cached != input && (!cached || !input || cached->data_ != input->data_))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool ImGuiNodesExecutor::LookupCache(Step &step)
+    {
+        if (cache_budget_ == 0)
+            return false;
+
+        auto iterator = cache_index_.find(step.key_);
+        if (iterator == cache_index_.end() || !IsCacheEntryOf(*iterator->second, step))
+        {
+            cache_misses_++;
+            return false;
+        }
+
+        cache_.splice(cache_.begin(), cache_, iterator->second);
+        cache_hits_++;
+
+        step.results_ = iterator->second->results_;
+        step.hashes_ = iterator->second->hashes_;
+        step.cached_ = true;
+        return true;
+    }
+
+    void ImGuiNodesExecutor::InsertCache(const Step &step)
+    {
+        if (cache_budget_ == 0)
+            return;
+
+        // the inputs are counted in full even though they are usually shared with other entries
+        size_t bytes = sizeof(CacheEntry) + step.key_.size() * sizeof(size_t) * 2;
+        for (const auto &result : step.results_)
+            bytes += sizeof(ImGuiNodesValue) + result->data_.size();
+        for (const auto &input : step.context_.inputs_)
+            bytes += sizeof(input) + (input ? input->data_.size() : 0);
+
+        if (bytes > cache_budget_)
+            return;
+
+        auto iterator = cache_index_.find(step.key_);
+        if (iterator != cache_index_.end())
+        {
+            if (IsCacheEntryOf(*iterator->second, step))
+            {
+                cache_.splice(cache_.begin(), cache_, iterator->second);
+                return;
+            }
+
+            // a collision, the newer result takes the key
+            cache_bytes_ -= iterator->second->bytes_;
+            cache_.erase(iterator->second);
+            cache_index_.erase(iterator);
+        }
+
+        cache_.push_front({step.key_, step.desc_name_, step.context_.inputs_, step.results_, step.hashes_, bytes});
+        cache_index_.emplace(step.key_, cache_.begin());
+        cache_bytes_ += bytes;
+
+        TrimCache(cache_budget_);
+    }
+
+    void ImGuiNodesExecutor::TrimCache(size_t budget)
+    {
+        while (cache_bytes_ > budget && !cache_.empty())
+        {
+            cache_bytes_ -= cache_.back().bytes_;
+            cache_index_.erase(cache_.back().key_);
+            cache_.pop_back();
+        }
+    }
+
+    void ImGuiNodesExecutor::SetKernel(const std::string_view &desc_name, ImGuiNodesKernel kernel, ImGuiNodesParamsHash params_hash)
+    {
+        kernels_[std::string(desc_name)] = {std::move(kernel), std::move(params_hash)};
+    }
+
+    void ImGuiNodesExecutor::SetStreamKernel(const std::string_view &desc_name, ImGuiNodesStreamKernel kernel)
+    {
+        stream_kernels_[std::string(desc_name)] = std::move(kernel);
+    }
+
+    void ImGuiNodesExecutor::SetCacheBudget(size_t budget)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        cache_budget_ = budget;
+        TrimCache(budget);
+    }
+
+    void ImGuiNodesExecutor::ClearCache()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        TrimCache(0);
+    }
+
+    ImGuiNodesCacheStats ImGuiNodesExecutor::GetCacheStats()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        return {cache_hits_, cache_misses_, cache_.size(), cache_bytes_, cache_budget_};
+    }
+
+    void ImGuiNodesExecutor::Execute(ImGuiNodes &nodes, ImGuiNodesNode *node)
+    {
+        Track(nodes);
+        Cancel(nodes);
+
+        const std::vector<ImGuiNodesNode *> &graph = nodes.GetNodes();
+        if (graph.empty())
+            return;
+
+        std::shared_ptr<Job> job = std::make_shared<Job>();
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<ImGuiNodesNode *> ordered;
+        std::unordered_map<const ImGuiNodesNode *, size_t> order;
+        SortUpstream(graph, node, ordered, order);
+
+        job->steps_.resize(ordered.size());
+        for (size_t step_idx = 0; step_idx < ordered.size(); ++step_idx)
+        {
+            job->steps_[step_idx].node_ = ordered[step_idx];
+            job->steps_[step_idx].id_ = ordered[step_idx]->id_;
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        for (size_t step_idx = 0; step_idx < job->steps_.size(); ++step_idx)
+        {
+            Step &step = job->steps_[step_idx];
+            ImGuiNodesNode *current = step.node_;
+
+            step.sources_.resize(current->inputs_.size(), {SIZE_MAX, 0});
+            step.results_.resize(current->outputs_.size());
+            step.hashes_.resize(current->outputs_.size());
+            step.context_.inputs_.resize(current->inputs_.size());
+            step.context_.outputs_.resize(current->outputs_.size());
+            step.context_.user_data_ = current->user_data_;
+            step.context_.cancelled_ = &job->cancelled_;
+
+            for (size_t input_idx = 0; input_idx < current->inputs_.size(); ++input_idx)
+            {
+                const ImGuiNodesInput &input = current->inputs_[input_idx];
+
+                if (!input.target_ || !input.output_)
+                    continue;
+
+                size_t source_idx = order[input.target_];
+                if (source_idx >= step_idx)
+                    continue;
+
+                step.sources_[input_idx] = {source_idx, size_t(input.output_ - input.target_->outputs_.data())};
+                job->steps_[source_idx].successors_.push_back(step_idx);
+                step.pending_++;
+            }
+
+            auto kernel = current->desc_ ? kernels_.find(current->desc_->name_) : kernels_.end();
+
+            if (kernel == kernels_.end() || current->state_ & ImGuiNodesNodeStateFlag_Disabled)
+                step.skipped_ = true;
+            else
+            {
+                step.kernel_ = kernel->second.kernel_;
+                step.desc_name_ = kernel->first;
+                step.key_.push_back(std::hash<std::string_view>{}(current->desc_->name_));
+                step.key_.push_back(kernel->second.params_hash_ ? kernel->second.params_hash_(current) : 0);
+                current->state_ |= ImGuiNodesNodeStateFlag_Executing;
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        job_ = job;
+        job->remaining_ = job->steps_.size();
+
+        // collect the roots first, finishing skipped or cached steps inline releases their successors
+        std::vector<size_t> roots;
+        for (size_t step_idx = 0; step_idx < job->steps_.size(); ++step_idx)
+            if (job->steps_[step_idx].pending_ == 0)
+                roots.push_back(step_idx);
+
+        for (size_t step_idx : roots)
+            if (!PrepareStep(job, step_idx))
+                FinishStep(job, step_idx);
+    }
+
+    void ImGuiNodesExecutor::ExecuteStream(ImGuiNodes &nodes, ImGuiNodesNode *node)
+    {
+        Track(nodes);
+        Cancel(nodes);
+
+        const std::vector<ImGuiNodesNode *> &graph = nodes.GetNodes();
+        if (graph.empty())
+            return;
+
+        std::vector<ImGuiNodesNode *> ordered;
+        std::unordered_map<const ImGuiNodesNode *, size_t> order;
+        SortUpstream(graph, node, ordered, order);
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<size_t> stage_of(ordered.size(), SIZE_MAX);
+        size_t stage_count = 0;
+
+        for (size_t node_idx = 0; node_idx < ordered.size(); ++node_idx)
+        {
+            const ImGuiNodesNode *current = ordered[node_idx];
+
+            if (current->state_ & ImGuiNodesNodeStateFlag_Disabled || !current->desc_)
+                continue;
+
+            if (stream_kernels_.count(current->desc_->name_))
+                stage_of[node_idx] = stage_count++;
+        }
+
+        if (stage_count == 0)
+            return;
+
+        std::unique_ptr<Stream> stream = std::make_unique<Stream>();
+        stream->stages_ = std::vector<Stage>(stage_count);
+        stream->remaining_ = stage_count;
+
+        for (size_t node_idx = 0; node_idx < ordered.size(); ++node_idx)
+        {
+            if (stage_of[node_idx] == SIZE_MAX)
+                continue;
+
+            ImGuiNodesNode *current = ordered[node_idx];
+            Stage &stage = stream->stages_[stage_of[node_idx]];
+
+            stage.node_ = current;
+            stage.id_ = current->id_;
+            stage.kernel_ = stream_kernels_[current->desc_->name_];
+            stage.context_.user_data_ = current->user_data_;
+            stage.context_.inputs_.resize(current->inputs_.size());
+            stage.context_.outputs_.resize(current->outputs_.size());
+            stage.context_.cancelled_ = &stream->cancelled_;
+
+            current->state_ |= ImGuiNodesNodeStateFlag_Executing;
+
+            for (size_t input_idx = 0; input_idx < current->inputs_.size(); ++input_idx)
+            {
+                const ImGuiNodesInput &input = current->inputs_[input_idx];
+
+                if (!input.target_ || !input.output_ || input.output_->type_ != ImGuiNodesConnectorType_Text)
+                    continue;
+
+                size_t source_idx = order[input.target_];
+                if (source_idx >= node_idx || stage_of[source_idx] == SIZE_MAX)
+                    continue;
+
+                auto queue = std::make_shared<ImGuiNodesChunkQueue>(stream_capacity_);
+                size_t slot = input.output_ - input.target_->outputs_.data();
+
+                stage.context_.inputs_[input_idx] = queue;
+                stream->stages_[stage_of[source_idx]].context_.outputs_[slot].push_back(queue);
+                stream->queues_.push_back(queue);
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        for (Stage &stage : stream->stages_)
+        {
+            std::atomic<size_t> *remaining = &stream->remaining_;
+
+            stage.thread_ = std::thread(
+                [&stage, remaining]
+                {
+                    auto start = std::chrono::steady_clock::now();
+
+                    try
+                    {
+                        stage.kernel_(stage.context_);
+                    }
+                    catch (...)
+                    {
+                        stage.exception_ = std::current_exception();
+                    }
+
+                    // closing both ends tells consumers the stream ended and unblocks producers we stopped reading,
+                    // the consumers of a failed stage get no more chunks than it wrote before throwing
+                    for (const auto &output : stage.context_.outputs_)
+                        for (const auto &queue : output)
+                            queue->Close();
+
+                    for (const auto &input : stage.context_.inputs_)
+                        if (input)
+                            input->Close();
+
+                    stage.time_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() - stage.context_.blocked_;
+                    stage.done_ = true;
+                    (*remaining)--;
+                });
+        }
+
+        stream_ = std::move(stream);
+    }
+
+    void ImGuiNodesExecutor::Cancel(ImGuiNodes &nodes)
+    {
+        if (!job_ && !stream_)
+            return;
+
+        // the nodes of a replaced graph are freed, only flags of the running graph are cleared
+        std::unordered_set<const ImGuiNodesNode *> alive;
+        if (IsTracked(nodes))
+            alive.insert(nodes.GetNodes().begin(), nodes.GetNodes().end());
+
+        if (job_)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                job_->cancelled_ = true;
+
+                ready_.erase(std::remove_if(ready_.begin(), ready_.end(), [this](const StepRef &ref)
+                                            { return ref.first == job_; }),
+                             ready_.end());
+                finished_.clear();
+            }
+
+            for (Step &step : job_->steps_)
+                if (IsAlive(alive, step.node_, step.id_))
+                    step.node_->state_ &= ~ImGuiNodesNodeStateFlag_Executing;
+
+            job_.reset();
+        }
+
+        if (stream_)
+        {
+            stream_->cancelled_ = true;
+
+            for (const auto &queue : stream_->queues_)
+                queue->Close();
+
+            for (Stage &stage : stream_->stages_)
+                if (IsAlive(alive, stage.node_, stage.id_))
+                    stage.node_->state_ &= ~ImGuiNodesNodeStateFlag_Executing;
+
+            retired_streams_.push_back(std::move(stream_));
+        }
+    }
+
+    void ImGuiNodesExecutor::RetireStreams(bool wait)
+    {
+        for (auto iterator = retired_streams_.begin(); iterator != retired_streams_.end();)
+        {
+            Stream &stream = **iterator;
+
+            if (!wait && stream.remaining_ != 0)
+            {
+                ++iterator;
+                continue;
+            }
+
+            for (Stage &stage : stream.stages_)
+                if (stage.thread_.joinable())
+                    stage.thread_.join();
+
+            iterator = retired_streams_.erase(iterator);
+        }
+    }
+
+    void ImGuiNodesExecutor::Track(ImGuiNodes &nodes)
+    {
+        if (IsTracked(nodes))
+            return;
+
+        Cancel(nodes);
+        results_.clear();
+
+        graph_ = &nodes;
+        generation_ = nodes.GetGeneration();
+    }
+
+    void ImGuiNodesExecutor::Commit(ImGuiNodes &nodes)
+    {
+        RetireStreams(false);
+        Track(nodes);
+
+        std::vector<StepRef> finished;
+        bool idle = false;
+
+        if (job_)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            finished.swap(finished_);
+            idle = job_->remaining_ == 0;
+        }
+
+        bool streamed = false;
+
+        if (stream_)
+            for (const Stage &stage : stream_->stages_)
+                streamed |= stage.done_ && !stage.committed_;
+
+        if (finished.empty() && !streamed)
+            return;
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        const std::vector<ImGuiNodesNode *> &graph = nodes.GetNodes();
+        std::unordered_set<const ImGuiNodesNode *> alive(graph.begin(), graph.end());
+
+        for (const auto &[job, step_idx] : finished)
+        {
+            Step &step = job->steps_[step_idx];
+
+            if (!IsAlive(alive, step.node_, step.id_))
+                continue;
+
+            step.node_->state_ &= ~ImGuiNodesNodeStateFlag_Executing;
+            results_[step.id_] = step.results_;
+
+            if (!step.skipped_ && !step.cached_)
+            {
+                step.node_->profile_.time_ += step.time_;
+                step.node_->profile_.calls_++;
+                step.node_->profile_.bytes_ += step.bytes_;
+            }
+        }
+
+        if (idle)
+        {
+            job_.reset();
+
+            std::unordered_set<uint32_t> ids;
+            for (const ImGuiNodesNode *current : graph)
+                ids.insert(current->id_);
+
+            for (auto iterator = results_.begin(); iterator != results_.end();)
+            {
+                if (ids.count(iterator->first))
+                    ++iterator;
+                else
+                    iterator = results_.erase(iterator);
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        if (streamed)
+        {
+            for (Stage &stage : stream_->stages_)
+            {
+                if (stage.committed_ || !stage.done_)
+                    continue;
+
+                stage.committed_ = true;
+
+                if (!IsAlive(alive, stage.node_, stage.id_))
+                    continue;
+
+                stage.node_->state_ &= ~ImGuiNodesNodeStateFlag_Executing;
+                stage.node_->profile_.time_ += stage.time_;
+                stage.node_->profile_.calls_++;
+
+                // like a failed task, a failed stage leaves no outputs behind
+                if (stage.Failed())
+                    results_[stage.id_].assign(stage.node_->outputs_.size(), nullptr);
+                else
+                    stage.node_->profile_.bytes_ += stage.context_.written_;
+            }
+
+            if (stream_->remaining_ == 0)
+            {
+                retired_streams_.push_back(std::move(stream_));
+                RetireStreams(false);
+            }
+        }
+    }
+
+    const ImGuiNodesValue *ImGuiNodesExecutor::GetOutput(const ImGuiNodesNode *node, size_t slot) const
+    {
+        if (!node || !graph_ || graph_->GetGeneration() != generation_)
+            return nullptr;
+
+        auto iterator = results_.find(node->id_);
+        if (iterator == results_.end() || iterator->second.size() <= slot)
+            return nullptr;
+
+        return iterator->second[slot].get();
+    }
+
+    ImGuiNodesExecutor::ImGuiNodesExecutor(unsigned int worker_count)
+    {
+        worker_count = (std::max)(1u, worker_count);
+
+        for (unsigned int worker_idx = 0; worker_idx < worker_count; ++worker_idx)
+            workers_.emplace_back(&ImGuiNodesExecutor::WorkerLoop, this);
+    }
+
+    ImGuiNodesExecutor::~ImGuiNodesExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            quit_ = true;
+
+            if (job_)
+                job_->cancelled_ = true;
+        }
+
+        condition_.notify_all();
+
+        for (std::thread &worker : workers_)
+            worker.join();
+
+        if (stream_)
+        {
+            stream_->cancelled_ = true;
+
+            for (const auto &queue : stream_->queues_)
+                queue->Close();
+
+            retired_streams_.push_back(std::move(stream_));
+        }
+
+        RetireStreams(true);
+    }
+}
@@ -0,0 +1,383 @@
+#ifndef IMGUI_NODES_EXECUTOR_H // !IMGUI_NODES_EXECUTOR_H
+#define IMGUI_NODES_EXECUTOR_H
+
+#include "ImGuiNodes.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace ImGui
+{
+    ////////////////////////////////////////////////////////////////////////////////
+
+    struct ImGuiNodesValue
+    {
+        std::vector<unsigned char> data_;
+
+        template <typename T>
+        inline void Set(const T &value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            data_.resize(sizeof(T));
+            memcpy(data_.data(), &value, sizeof(T));
+        }
+
+        template <typename T>
+        inline T Get(T fallback = {}) const
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            if (data_.size() != sizeof(T))
+                return fallback;
+
+            T value;
+            memcpy(&value, data_.data(), sizeof(T));
+            return value;
+        }
+
+        inline void SetText(std::string_view text)
+        {
+            data_.assign(text.begin(), text.end());
+        }
+
+        inline std::string_view GetText() const
+        {
+            return std::string_view(reinterpret_cast<const char *>(data_.data()), data_.size());
+        }
+
+        inline bool Empty() const { return data_.empty(); }
+
+        inline size_t Hash() const { return std::hash<std::string_view>{}(GetText()); }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // node kernels are coroutines, every co_await hands the worker back to the scheduler
+    struct ImGuiNodesTask
+    {
+        struct promise_type
+        {
+            std::exception_ptr exception_;
+
+            ImGuiNodesTask get_return_object() { return ImGuiNodesTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { exception_ = std::current_exception(); }
+        };
+
+        std::coroutine_handle<promise_type> handle_;
+
+        inline bool Resume()
+        {
+            if (handle_ && !handle_.done())
+                handle_.resume();
+
+            return Done();
+        }
+
+        inline bool Done() const { return !handle_ || handle_.done(); }
+        inline bool Failed() const { return handle_ && handle_.promise().exception_; }
+
+        ImGuiNodesTask() = default;
+        explicit ImGuiNodesTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+        ImGuiNodesTask(ImGuiNodesTask &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+        ImGuiNodesTask(const ImGuiNodesTask &) = delete;
+
+        ImGuiNodesTask &operator=(ImGuiNodesTask &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    handle_.destroy();
+
+                handle_ = std::exchange(other.handle_, {});
+            }
+
+            return *this;
+        }
+
+        ImGuiNodesTask &operator=(const ImGuiNodesTask &) = delete;
+
+        ~ImGuiNodesTask()
+        {
+            if (handle_)
+                handle_.destroy();
+        }
+    };
+
+    // co_await ImGuiNodesYield{} lets other kernels run and the executor honor cancellation
+    struct ImGuiNodesYield : std::suspend_always
+    {
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    struct ImGuiNodesExecutionContext
+    {
+        void *user_data_ = nullptr;
+        std::vector<std::shared_ptr<const ImGuiNodesValue>> inputs_;
+        std::vector<ImGuiNodesValue> outputs_;
+        const std::atomic<bool> *cancelled_ = nullptr;
+
+        inline const ImGuiNodesValue *GetInput(size_t slot) const
+        {
+            return slot < inputs_.size() ? inputs_[slot].get() : nullptr;
+        }
+
+        inline bool IsCancelled() const { return cancelled_ && cancelled_->load(std::memory_order_relaxed); }
+    };
+
+    typedef std::function<ImGuiNodesTask(ImGuiNodesExecutionContext &context)> ImGuiNodesKernel;
+
+    // hashes whatever node state (usually user_data_) the kernel reads besides its inputs, runs on the UI thread,
+    // the cache trusts it, two params with the same hash share results
+    typedef std::function<size_t(const ImGuiNodesNode *node)> ImGuiNodesParamsHash;
+
+    struct ImGuiNodesCacheStats
+    {
+        size_t hits_;
+        size_t misses_;
+        size_t entries_;
+        size_t bytes_;
+        size_t budget_;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // bounded chunk queue carried by text connectors in streaming mode, a full queue blocks the producer
+    struct ImGuiNodesChunkQueue
+    {
+    private:
+        std::mutex mutex_;
+        std::condition_variable readable_;
+        std::condition_variable writable_;
+        std::deque<std::string> chunks_;
+        size_t capacity_;
+        bool closed_ = false;
+
+    public:
+        bool Push(std::string &&chunk);
+        bool Pop(std::string &chunk);
+        void Close();
+
+        ImGuiNodesChunkQueue(size_t capacity) : capacity_((std::max)(size_t(1), capacity)) {}
+    };
+
+    struct ImGuiNodesStreamContext
+    {
+        void *user_data_ = nullptr;
+        std::vector<std::shared_ptr<ImGuiNodesChunkQueue>> inputs_;
+        std::vector<std::vector<std::shared_ptr<ImGuiNodesChunkQueue>>> outputs_;
+        const std::atomic<bool> *cancelled_ = nullptr;
+
+        // profiling, time spent waiting on queues is not charged to the stage
+        double blocked_ = 0.0;
+        size_t written_ = 0;
+
+        // false once the input is unconnected, drained or cancelled
+        bool Read(size_t slot, std::string &chunk);
+
+        // fans the chunk out to every consumer of the slot, false once none of them takes chunks anymore
+        bool Write(size_t slot, std::string_view chunk);
+
+        inline bool IsConnected(size_t slot) const { return slot < inputs_.size() && inputs_[slot]; }
+        inline bool IsCancelled() const { return cancelled_ && cancelled_->load(std::memory_order_relaxed); }
+    };
+
+    // stream kernels run to completion on a thread of their own, one pipeline stage per node
+    typedef std::function<void(ImGuiNodesStreamContext &context)> ImGuiNodesStreamKernel;
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    struct ImGuiNodesExecutor
+    {
+    private:
+        struct Step
+        {
+            ImGuiNodesNode *node_ = nullptr;
+            uint32_t id_ = 0; // the node's id when scheduled, a new node may take the address of a freed one
+            ImGuiNodesKernel kernel_;
+            ImGuiNodesExecutionContext context_;
+            ImGuiNodesTask task_;
+
+            std::vector<std::pair<size_t, size_t>> sources_;
+            std::vector<size_t> successors_;
+            std::vector<std::shared_ptr<const ImGuiNodesValue>> results_;
+            std::vector<size_t> hashes_;
+            std::vector<size_t> key_;
+            std::string_view desc_name_; // the key in kernels_, which are never erased
+            size_t pending_ = 0;
+            bool skipped_ = false;
+            bool cached_ = false;
+
+            double time_ = 0.0;
+            size_t bytes_ = 0;
+        };
+
+        struct Job
+        {
+            std::vector<Step> steps_;
+            std::atomic<bool> cancelled_ = false;
+            size_t remaining_ = 0;
+        };
+
+        typedef std::pair<std::shared_ptr<Job>, size_t> StepRef;
+
+        struct Kernel
+        {
+            ImGuiNodesKernel kernel_;
+            ImGuiNodesParamsHash params_hash_;
+        };
+
+        struct Stage
+        {
+            ImGuiNodesNode *node_ = nullptr;
+            uint32_t id_ = 0;
+            ImGuiNodesStreamKernel kernel_;
+            ImGuiNodesStreamContext context_;
+            std::thread thread_;
+            std::atomic<bool> done_ = false;
+            bool committed_ = false;
+            std::exception_ptr exception_; // thrown by the kernel, read once done_ is set
+
+            double time_ = 0.0;
+
+            inline bool Failed() const { return exception_ != nullptr; }
+        };
+
+        struct Stream
+        {
+            std::vector<Stage> stages_;
+            std::vector<std::shared_ptr<ImGuiNodesChunkQueue>> queues_;
+            std::atomic<bool> cancelled_ = false;
+            std::atomic<size_t> remaining_ = 0;
+        };
+
+        // results are keyed by (desc, params hash, input hashes) and shared with the steps that produced them,
+        // a hit also compares the desc name and the input values so a hash collision is only a miss,
+        // the params are only known by their hash
+        struct CacheEntry
+        {
+            std::vector<size_t> key_;
+            std::string_view desc_name_;
+            std::vector<std::shared_ptr<const ImGuiNodesValue>> inputs_;
+            std::vector<std::shared_ptr<const ImGuiNodesValue>> results_;
+            std::vector<size_t> hashes_;
+            size_t bytes_;
+        };
+
+        struct CacheKeyHash
+        {
+            size_t operator()(const std::vector<size_t> &key) const
+            {
+                return std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char *>(key.data()), key.size() * sizeof(size_t)));
+            }
+        };
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<std::string, Kernel> kernels_;
+        std::unordered_map<std::string, ImGuiNodesStreamKernel> stream_kernels_;
+        // by node id, ids are only unique within a generation of the graph they were run on
+        std::unordered_map<uint32_t, std::vector<std::shared_ptr<const ImGuiNodesValue>>> results_;
+        const ImGuiNodes *graph_ = nullptr;
+        uint32_t generation_ = 0;
+
+        std::shared_ptr<Job> job_;
+
+        std::unique_ptr<Stream> stream_;
+        std::vector<std::unique_ptr<Stream>> retired_streams_;
+        size_t stream_capacity_ = 16;
+
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        std::deque<StepRef> ready_;
+        std::vector<StepRef> finished_;
+        std::vector<std::thread> workers_;
+        bool quit_ = false;
+
+        std::list<CacheEntry> cache_;
+        std::unordered_map<std::vector<size_t>, std::list<CacheEntry>::iterator, CacheKeyHash> cache_index_;
+        size_t cache_bytes_ = 0;
+        size_t cache_budget_ = 0;
+        size_t cache_hits_ = 0;
+        size_t cache_misses_ = 0;
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+    private:
+        void WorkerLoop();
+        bool PrepareStep(const std::shared_ptr<Job> &job, size_t step_idx);
+        void FinishStep(const std::shared_ptr<Job> &job, size_t step_idx);
+
+        static void SortUpstream(const std::vector<ImGuiNodesNode *> &graph, ImGuiNodesNode *node, std::vector<ImGuiNodesNode *> &ordered, std::unordered_map<const ImGuiNodesNode *, size_t> &order);
+
+        void RetireStreams(bool wait);
+        // drops the results and the running work once the graph was replaced, its nodes are gone
+        void Track(ImGuiNodes &nodes);
+        bool IsTracked(const ImGuiNodes &nodes) const { return graph_ == &nodes && generation_ == nodes.GetGeneration(); }
+        static bool IsAlive(const std::unordered_set<const ImGuiNodesNode *> &alive, const ImGuiNodesNode *node, uint32_t id) { return alive.count(node) && node->id_ == id; }
+
+        static bool IsCacheEntryOf(const CacheEntry &entry, const Step &step);
+        bool LookupCache(Step &step);
+        void InsertCache(const Step &step);
+        void TrimCache(size_t budget);
+
+    public:
+        void SetKernel(const std::string_view &desc_name, ImGuiNodesKernel kernel, ImGuiNodesParamsHash params_hash = nullptr);
+
+        // memory budget of the result cache in bytes, zero disables caching
+        void SetCacheBudget(size_t budget);
+        void ClearCache();
+        ImGuiNodesCacheStats GetCacheStats();
+
+        void SetStreamKernel(const std::string_view &desc_name, ImGuiNodesStreamKernel kernel);
+
+        // chunks buffered per text connection in streaming mode
+        void SetStreamCapacity(size_t capacity) { stream_capacity_ = capacity; }
+
+        // schedules the node and everything upstream of it, or the whole graph when node is null
+        void Execute(ImGuiNodes &nodes, ImGuiNodesNode *node = nullptr);
+
+        // same selection as Execute(), but every stream kernel runs concurrently and text connectors carry chunk queues
+        void ExecuteStream(ImGuiNodes &nodes, ImGuiNodesNode *node = nullptr);
+
+        void Cancel(ImGuiNodes &nodes);
+
+        // call once per frame on the UI thread, finished nodes publish their outputs here
+        void Commit(ImGuiNodes &nodes);
+
+        bool IsRunning() const { return job_ != nullptr || stream_ != nullptr; }
+
+        // null until the node ran, and for nodes of a graph cleared or loaded since
+        const ImGuiNodesValue *GetOutput(const ImGuiNodesNode *node, size_t slot) const;
+
+        ImGuiNodesExecutor(unsigned int worker_count = 1);
+        ~ImGuiNodesExecutor();
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+}
+
+#if defined(IMGUI_NODES_HEADER_ONLY)
+#include "ImGuiNodesExecutor.cc"
+#endif
+
+#endif // !IMGUI_NODES_EXECUTOR_H
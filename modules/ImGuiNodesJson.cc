@@ -0,0 +1,1147 @@
+#include "ImGuiNodesJson.h"
+
+#include <string.h>
+
+#include <charconv>
+#include <unordered_map>
+
+namespace ImGui
+{
+    bool ImGuiNodesJsonReader::Refill()
+    {
+        base_ += end_ - buffer_.get();
+
+        const size_t size = fread(buffer_.get(), 1, BufferSize, file_);
+
+        cursor_ = buffer_.get();
+        end_ = cursor_ + size;
+
+        return size > 0;
+    }
+
+    int ImGuiNodesJsonReader::Peek()
+    {
+        if (cursor_ == end_ && !Refill())
+            return EOF;
+
+        return static_cast<unsigned char>(*cursor_);
+    }
+
+    int ImGuiNodesJsonReader::SkipWhitespace()
+    {
+        for (;;)
+        {
+            const int c = Peek();
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+                return c;
+
+            ++cursor_;
+        }
+    }
+
+    bool ImGuiNodesJsonReader::ReadHex(uint32_t &value)
+    {
+        value = 0;
+
+        for (int digit_idx = 0; digit_idx < 4; ++digit_idx)
+        {
+            const int c = Peek();
+
+            if (c >= '0' && c <= '9')
+                value = (value << 4) | (c - '0');
+            else if (c >= 'a' && c <= 'f')
+                value = (value << 4) | (c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                value = (value << 4) | (c - 'A' + 10);
+            else
+                return false;
+
+            ++cursor_;
+        }
+
+        return true;
+    }
+
+    bool ImGuiNodesJsonReader::ReadString()
+    {
+        token_.clear();
+
+        for (;;)
+        {
+            if (cursor_ == end_ && !Refill())
+                return false;
+
+            const char *run = cursor_;
+
+            while (cursor_ != end_ && *cursor_ != '"' && *cursor_ != '\\' && static_cast<unsigned char>(*cursor_) >= 0x20)
+                ++cursor_;
+
+            token_.append(run, cursor_);
+
+            if (token_.size() > MaxStringSize)
+                return false;
+
+            if (cursor_ == end_)
+                continue;
+
+            const char c = *cursor_++;
+
+            if (c == '"')
+                return true;
+
+            if (c != '\\')
+                return false;
+
+            const int escape = Peek();
+            if (escape == EOF)
+                return false;
+
+            ++cursor_;
+
+            switch (escape)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                token_.push_back(static_cast<char>(escape));
+                break;
+            case 'b':
+                token_.push_back('\b');
+                break;
+            case 'f':
+                token_.push_back('\f');
+                break;
+            case 'n':
+                token_.push_back('\n');
+                break;
+            case 'r':
+                token_.push_back('\r');
+                break;
+            case 't':
+                token_.push_back('\t');
+                break;
+            case 'u':
+            {
+                uint32_t codepoint;
+                if (!ReadHex(codepoint))
+                    return false;
+
+                if (codepoint >= 0xDC00 && codepoint <= 0xDFFF)
+                    return false;
+
+                if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+                {
+                    uint32_t low;
+
+                    if (Peek() != '\\')
+                        return false;
+                    ++cursor_;
+
+                    if (Peek() != 'u')
+                        return false;
+                    ++cursor_;
+
+                    if (!ReadHex(low) || low < 0xDC00 || low > 0xDFFF)
+                        return false;
+
+                    codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+
+                if (codepoint < 0x80)
+                    token_.push_back(static_cast<char>(codepoint));
+                else if (codepoint < 0x800)
+                {
+                    token_.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+                    token_.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+                }
+                else if (codepoint < 0x10000)
+                {
+                    token_.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+                    token_.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+                    token_.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+                }
+                else
+                {
+                    token_.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+                    token_.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+                    token_.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+                    token_.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+                }
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+    }
+
+    bool ImGuiNodesJsonReader::ReadNumber(double &value)
+    {
+        char number[64];
+        size_t size = 0;
+
+        for (int c = Peek(); (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'; c = Peek())
+        {
+            if (size == sizeof(number))
+                return false;
+
+            number[size++] = static_cast<char>(c);
+            ++cursor_;
+        }
+
+        auto [end, error] = std::from_chars(number, number + size, value);
+
+        return error == std::errc() && end == number + size;
+    }
+
+    bool ImGuiNodesJsonReader::ReadLiteral(const char *literal)
+    {
+        for (; *literal; ++literal, ++cursor_)
+            if (Peek() != *literal)
+                return false;
+
+        return true;
+    }
+
+    bool ImGuiNodesJsonReader::Parse(FILE *file, ImGuiNodesJsonHandler &handler)
+    {
+        enum
+        {
+            Expect_Value,
+            Expect_FirstKey,
+            Expect_FirstValue,
+            Expect_Key,
+            Expect_Next
+        };
+
+        file_ = file;
+        cursor_ = end_ = buffer_.get();
+        base_ = 0;
+
+        char stack[MaxDepth];
+        size_t depth = 0;
+        int expect = Expect_Value;
+
+        for (;;)
+        {
+            const int c = SkipWhitespace();
+
+            if (expect == Expect_FirstKey || expect == Expect_FirstValue)
+            {
+                if (c == (expect == Expect_FirstKey ? '}' : ']'))
+                {
+                    ++cursor_;
+                    --depth;
+
+                    if (!(c == '}' ? handler.EndObject() : handler.EndArray()))
+                        return false;
+
+                    expect = Expect_Next;
+                    continue;
+                }
+
+                expect = expect == Expect_FirstKey ? Expect_Key : Expect_Value;
+            }
+
+            if (expect == Expect_Key)
+            {
+                if (c != '"')
+                    return false;
+
+                ++cursor_;
+
+                if (!ReadString() || !handler.Key(token_))
+                    return false;
+
+                if (SkipWhitespace() != ':')
+                    return false;
+
+                ++cursor_;
+
+                expect = Expect_Value;
+                continue;
+            }
+
+            if (expect == Expect_Next)
+            {
+                if (0 == depth)
+                    return c == EOF;
+
+                if (c == ',')
+                {
+                    ++cursor_;
+                    expect = stack[depth - 1] == '{' ? Expect_Key : Expect_Value;
+                    continue;
+                }
+
+                if (c != (stack[depth - 1] == '{' ? '}' : ']'))
+                    return false;
+
+                ++cursor_;
+                --depth;
+
+                if (!(c == '}' ? handler.EndObject() : handler.EndArray()))
+                    return false;
+
+                continue;
+            }
+
+            ////////////////////////////////////////////////////////////////////////////////
+
+            bool succeed;
+
+            switch (c)
+            {
+            case '{':
+            case '[':
+                if (MaxDepth == depth)
+                    return false;
+
+                ++cursor_;
+                stack[depth++] = static_cast<char>(c);
+
+                if (!(c == '{' ? handler.BeginObject() : handler.BeginArray()))
+                    return false;
+
+                expect = c == '{' ? Expect_FirstKey : Expect_FirstValue;
+                continue;
+            case '"':
+                ++cursor_;
+                succeed = ReadString() && handler.String(token_);
+                break;
+            case 't':
+                succeed = ReadLiteral("true") && handler.Bool(true);
+                break;
+            case 'f':
+                succeed = ReadLiteral("false") && handler.Bool(false);
+                break;
+            case 'n':
+                succeed = ReadLiteral("null") && handler.Null();
+                break;
+            default:
+                double value;
+                succeed = (c == '-' || (c >= '0' && c <= '9')) && ReadNumber(value) && handler.Number(value);
+                break;
+            }
+
+            if (!succeed)
+                return false;
+
+            expect = Expect_Next;
+        }
+    }
+
+    bool ImGuiNodesJsonReader::Parse(const char *path, ImGuiNodesJsonHandler &handler)
+    {
+        FILE *file = fopen(path, "rb");
+        if (nullptr == file)
+            return false;
+
+        const bool succeed = Parse(file, handler);
+
+        fclose(file);
+
+        return succeed;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    bool ImGuiNodesJsonWriter::Open(const char *path)
+    {
+        Close();
+
+        file_ = fopen(path, "wb");
+        used_ = 0;
+        flushed_ = 0;
+        failed_ = false;
+        depth_ = 0;
+        arrays_ = 0;
+        filled_ = 0;
+        after_key_ = false;
+
+        return nullptr != file_;
+    }
+
+    bool ImGuiNodesJsonWriter::Close()
+    {
+        if (nullptr == file_)
+            return false;
+
+        Flush();
+
+        const bool succeed = 0 == fclose(file_) && !failed_ && 0 == depth_;
+
+        file_ = nullptr;
+
+        return succeed;
+    }
+
+    void ImGuiNodesJsonWriter::Flush()
+    {
+        if (used_ > 0 && used_ != fwrite(buffer_.get(), 1, used_, file_))
+            failed_ = true;
+
+        flushed_ += used_;
+        used_ = 0;
+    }
+
+    void ImGuiNodesJsonWriter::Put(char c)
+    {
+        if (BufferSize == used_)
+            Flush();
+
+        buffer_[used_++] = c;
+    }
+
+    void ImGuiNodesJsonWriter::Put(const char *data, size_t size)
+    {
+        if (used_ + size > BufferSize)
+            Flush();
+
+        if (size >= BufferSize)
+        {
+            if (size != fwrite(data, 1, size, file_))
+                failed_ = true;
+
+            flushed_ += size;
+            return;
+        }
+
+        memcpy(buffer_.get() + used_, data, size);
+        used_ += size;
+    }
+
+    void ImGuiNodesJsonWriter::Separate()
+    {
+        if (after_key_)
+        {
+            after_key_ = false;
+            return;
+        }
+
+        if (0 == depth_)
+            return;
+
+        const uint64_t bit = uint64_t(1) << (depth_ - 1);
+
+        if (filled_ & bit)
+            Put(',');
+
+        filled_ |= bit;
+
+        // one line per top level entry and per element of the top level arrays
+        if (1 == depth_ || (2 == depth_ && arrays_ & bit))
+            Put('\n');
+    }
+
+    void ImGuiNodesJsonWriter::Begin(char c, bool array)
+    {
+        Separate();
+        Put(c);
+
+        if (MaxDepth == depth_)
+        {
+            failed_ = true;
+            return;
+        }
+
+        const uint64_t bit = uint64_t(1) << depth_++;
+
+        filled_ &= ~bit;
+        arrays_ = array ? arrays_ | bit : arrays_ & ~bit;
+    }
+
+    void ImGuiNodesJsonWriter::End(char c)
+    {
+        if (0 == depth_)
+        {
+            failed_ = true;
+            return;
+        }
+
+        const uint64_t bit = uint64_t(1) << (depth_ - 1);
+
+        if (filled_ & bit && (1 == depth_ || (2 == depth_ && arrays_ & bit)))
+            Put('\n');
+
+        Put(c);
+
+        --depth_;
+    }
+
+    void ImGuiNodesJsonWriter::Escaped(std::string_view value)
+    {
+        Put('"');
+
+        const char *run = value.data();
+        const char *end = value.data() + value.size();
+
+        for (const char *c = run; c != end; ++c)
+        {
+            const unsigned char character = static_cast<unsigned char>(*c);
+
+            if (character != '"' && character != '\\' && character >= 0x20)
+                continue;
+
+            Put(run, c - run);
+            run = c + 1;
+
+            switch (character)
+            {
+            case '"':
+                Put("\\\"", 2);
+                break;
+            case '\\':
+                Put("\\\\", 2);
+                break;
+            case '\n':
+                Put("\\n", 2);
+                break;
+            case '\r':
+                Put("\\r", 2);
+                break;
+            case '\t':
+                Put("\\t", 2);
+                break;
+            default:
+                char escape[8];
+                Put(escape, snprintf(escape, sizeof(escape), "\\u%04x", character));
+                break;
+            }
+        }
+
+        Put(run, end - run);
+        Put('"');
+    }
+
+    void ImGuiNodesJsonWriter::Key(std::string_view key)
+    {
+        Separate();
+        Escaped(key);
+        Put(':');
+
+        after_key_ = true;
+    }
+
+    void ImGuiNodesJsonWriter::String(std::string_view value)
+    {
+        Separate();
+        Escaped(value);
+    }
+
+    void ImGuiNodesJsonWriter::Integer(int64_t value)
+    {
+        char number[32];
+
+        Separate();
+        Put(number, std::to_chars(number, number + sizeof(number), value).ptr - number);
+    }
+
+    void ImGuiNodesJsonWriter::Number(double value)
+    {
+        char number[32];
+
+        Separate();
+
+        // JSON has no spelling for these
+        if (value != value || value - value != 0.0)
+        {
+            Put("null", 4);
+            return;
+        }
+
+        Put(number, std::to_chars(number, number + sizeof(number), value).ptr - number);
+    }
+
+    void ImGuiNodesJsonWriter::Number(float value)
+    {
+        char number[32];
+
+        Separate();
+
+        if (value != value || value - value != 0.0f)
+        {
+            Put("null", 4);
+            return;
+        }
+
+        Put(number, std::to_chars(number, number + sizeof(number), value).ptr - number);
+    }
+
+    void ImGuiNodesJsonWriter::Bool(bool value)
+    {
+        Separate();
+
+        if (value)
+            Put("true", 4);
+        else
+            Put("false", 5);
+    }
+
+    void ImGuiNodesJsonWriter::Null()
+    {
+        Separate();
+        Put("null", 4);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // collects the document into a batch, the editor only swaps it in once the whole document parsed
+    struct ImGuiNodesJsonImporter final : ImGuiNodesJsonHandler
+    {
+        enum Field
+        {
+            Field_Unknown = 0,
+            Field_Version,
+            Field_View,
+            Field_Scroll,
+            Field_Scale,
+            Field_Descs,
+            Field_Nodes,
+            Field_Edges,
+            Field_Name,
+            Field_Type,
+            Field_Color,
+            Field_Inputs,
+            Field_Outputs,
+            Field_Desc,
+            Field_Pos,
+            Field_Collapsed,
+            Field_Disabled,
+            Field_Selected
+        };
+
+        static constexpr int MaxDepth = 6;
+
+        ImGuiNodes &editor_;
+
+        int depth_ = 0;
+        int skip_ = 0; // depth inside a container nobody asked for
+        int fields_[MaxDepth] = {};
+        int index_ = 0; // element of the innermost number array
+        bool done_ = false;
+
+        bool has_view_ = false;
+        ImVec2 scroll_;
+        float scale_ = 1.0f;
+
+        std::vector<ImGuiNodesNodeDesc *> descs_;
+        std::vector<std::unique_ptr<ImGuiNodesNodeDesc>> staged_descs_; // registered once the import succeeded
+        ImGuiNodesBatch batch_;
+
+        ImGuiNodesNodeDesc desc_;
+        ImGuiNodesConnectionDesc connector_;
+
+        uint32_t node_desc_;
+        ImVec2 node_pos_;
+        const char *node_name_;
+        ImGuiNodesNodeState node_state_;
+
+        uint32_t edge_[4];
+
+        static int Lookup(std::string_view key)
+        {
+            static const std::pair<std::string_view, int> fields[] = {
+                {"version", Field_Version},
+                {"view", Field_View},
+                {"scroll", Field_Scroll},
+                {"scale", Field_Scale},
+                {"descs", Field_Descs},
+                {"nodes", Field_Nodes},
+                {"edges", Field_Edges},
+                {"name", Field_Name},
+                {"type", Field_Type},
+                {"color", Field_Color},
+                {"inputs", Field_Inputs},
+                {"outputs", Field_Outputs},
+                {"desc", Field_Desc},
+                {"pos", Field_Pos},
+                {"collapsed", Field_Collapsed},
+                {"disabled", Field_Disabled},
+                {"selected", Field_Selected},
+            };
+
+            for (const auto &[name, field] : fields)
+                if (name == key)
+                    return field;
+
+            return Field_Unknown;
+        }
+
+        static bool ToIndex(double value, uint32_t &index)
+        {
+            if (!(value >= 0.0 && value <= double(UINT32_MAX)) || value != double(uint32_t(value)))
+                return false;
+
+            index = uint32_t(value);
+            return true;
+        }
+
+        static bool CopyName(std::string_view value, char (&name)[ImGuiNodesNamesMaxLen])
+        {
+            if (value.size() >= ImGuiNodesNamesMaxLen || value.find('\0') != std::string_view::npos)
+                return false;
+
+            memcpy(name, value.data(), value.size());
+            name[value.size()] = '\0';
+            return true;
+        }
+
+        int Section() const { return depth_ > 1 ? fields_[1] : Field_Unknown; }
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        bool Begin(bool array)
+        {
+            if (skip_ > 0 || depth_ == MaxDepth)
+            {
+                ++skip_;
+                return true;
+            }
+
+            bool expected = false;
+
+            if (0 == depth_)
+                expected = !array;
+            else if (1 == depth_)
+                expected = array ? fields_[1] == Field_Descs || fields_[1] == Field_Nodes || fields_[1] == Field_Edges : fields_[1] == Field_View;
+            else if (2 == depth_ && Section() == Field_View)
+                expected = array && fields_[2] == Field_Scroll;
+            else if (2 == depth_)
+                expected = array ? Section() == Field_Edges : Section() == Field_Descs || Section() == Field_Nodes;
+            else if (3 == depth_ && Section() == Field_Descs)
+                expected = array && (fields_[3] == Field_Color || fields_[3] == Field_Inputs || fields_[3] == Field_Outputs);
+            else if (3 == depth_ && Section() == Field_Nodes)
+                expected = array && fields_[3] == Field_Pos;
+            else if (4 == depth_ && Section() == Field_Descs)
+                expected = !array && fields_[3] != Field_Color;
+
+            if (0 == depth_ && array)
+                return false;
+
+            if (!expected)
+            {
+                ++skip_;
+                return true;
+            }
+
+            fields_[++depth_] = Field_Unknown;
+            index_ = 0;
+
+            if (3 == depth_ && Section() == Field_Descs)
+            {
+                desc_ = ImGuiNodesNodeDesc{};
+                desc_.color_ = ImColor(0.5f, 0.5f, 0.5f, 1.0f);
+            }
+            else if (5 == depth_ && Section() == Field_Descs)
+                connector_ = ImGuiNodesConnectionDesc{};
+            else if (3 == depth_ && Section() == Field_Nodes)
+            {
+                node_desc_ = UINT32_MAX;
+                node_pos_ = ImVec2();
+                node_name_ = nullptr;
+                node_state_ = ImGuiNodesNodeStateFlag_Default;
+            }
+
+            return true;
+        }
+
+        bool End()
+        {
+            if (skip_ > 0)
+            {
+                --skip_;
+                return true;
+            }
+
+            const int depth = depth_--;
+
+            if (1 == depth)
+                return done_ = true;
+
+            if (3 == depth && Section() == Field_Descs)
+                return EndDesc();
+
+            if (5 == depth && Section() == Field_Descs)
+            {
+                if (fields_[3] == Field_Inputs)
+                    desc_.inputs_.push_back(connector_);
+                else
+                    desc_.outputs_.push_back(connector_);
+
+                return true;
+            }
+
+            if (3 == depth && Section() == Field_Nodes)
+                return EndNode();
+
+            if (3 == depth && Section() == Field_Edges)
+                return 4 == index_ && EndEdge();
+
+            return true;
+        }
+
+        bool EndDesc()
+        {
+            if ('\0' == desc_.name_[0])
+                return false;
+
+            // descs registered by the application win over the imported ones
+            ImGuiNodesNodeDesc *desc = editor_.FindNodeDesc(desc_.name_);
+            if (nullptr == desc)
+                desc = staged_descs_.emplace_back(new ImGuiNodesNodeDesc(std::move(desc_))).get();
+
+            descs_.push_back(desc);
+
+            return true;
+        }
+
+        bool EndNode()
+        {
+            if (node_desc_ >= descs_.size())
+                return false;
+
+            batch_.AddNode(descs_[node_desc_], node_pos_, node_state_, node_name_);
+
+            return true;
+        }
+
+        bool EndEdge()
+        {
+            if (edge_[0] >= batch_.nodes_.size() || edge_[2] >= batch_.nodes_.size())
+                return false;
+
+            batch_.AddEdge(edge_[0], edge_[1], edge_[2], edge_[3]);
+
+            return true;
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        bool Key(std::string_view key) override
+        {
+            if (0 == skip_)
+                fields_[depth_] = Lookup(key);
+
+            return true;
+        }
+
+        bool BeginObject() override { return Begin(false); }
+        bool EndObject() override { return End(); }
+        bool BeginArray() override { return Begin(true); }
+        bool EndArray() override { return End(); }
+
+        bool Null() override { return true; }
+
+        bool Bool(bool value) override
+        {
+            if (skip_ > 0 || 3 != depth_ || Section() != Field_Nodes)
+                return true;
+
+            ImGuiNodesNodeState flag = ImGuiNodesNodeStateFlag_Default;
+
+            if (fields_[3] == Field_Collapsed)
+                flag = ImGuiNodesNodeStateFlag_Collapsed;
+            else if (fields_[3] == Field_Disabled)
+                flag = ImGuiNodesNodeStateFlag_Disabled;
+            else if (fields_[3] == Field_Selected)
+                flag = ImGuiNodesNodeStateFlag_Selected;
+
+            node_state_ = value ? node_state_ | flag : node_state_ & ~flag;
+
+            return true;
+        }
+
+        bool Number(double value) override
+        {
+            if (skip_ > 0)
+                return true;
+
+            const int section = Section();
+
+            if (1 == depth_ && fields_[1] == Field_Version)
+                return value == ImGuiNodesJsonVersion;
+
+            if (2 == depth_ && section == Field_View && fields_[2] == Field_Scale)
+            {
+                scale_ = float(value);
+                has_view_ = true;
+                return true;
+            }
+
+            if (3 == depth_ && section == Field_View && fields_[2] == Field_Scroll)
+            {
+                if (index_ < 2)
+                    (0 == index_ ? scroll_.x : scroll_.y) = float(value);
+
+                ++index_;
+                has_view_ = true;
+                return true;
+            }
+
+            if (3 == depth_ && section == Field_Descs && fields_[3] == Field_Type)
+                return ToIndex(value, desc_.type_);
+
+            if (4 == depth_ && section == Field_Descs && fields_[3] == Field_Color)
+            {
+                if (index_ < 4)
+                    (&desc_.color_.Value.x)[index_] = float(value);
+
+                ++index_;
+                return true;
+            }
+
+            if (5 == depth_ && section == Field_Descs && fields_[5] == Field_Type)
+                return ToIndex(value, connector_.type_);
+
+            if (3 == depth_ && section == Field_Nodes && fields_[3] == Field_Desc)
+                return ToIndex(value, node_desc_);
+
+            if (4 == depth_ && section == Field_Nodes && fields_[3] == Field_Pos)
+            {
+                if (index_ < 2)
+                    (0 == index_ ? node_pos_.x : node_pos_.y) = float(value);
+
+                ++index_;
+                return true;
+            }
+
+            if (3 == depth_ && section == Field_Edges)
+                return index_ < 4 && ToIndex(value, edge_[index_++]);
+
+            return true;
+        }
+
+        bool String(std::string_view value) override
+        {
+            if (skip_ > 0)
+                return true;
+
+            const int section = Section();
+
+            if (3 == depth_ && section == Field_Descs && fields_[3] == Field_Name)
+                return CopyName(value, desc_.name_);
+
+            if (5 == depth_ && section == Field_Descs && fields_[5] == Field_Name)
+                return CopyName(value, connector_.name_);
+
+            if (3 == depth_ && section == Field_Nodes && fields_[3] == Field_Name)
+            {
+                node_name_ = batch_.CopyName(value);
+                return true;
+            }
+
+            return true;
+        }
+
+        ImGuiNodesJsonImporter(ImGuiNodes &editor) : editor_(editor) { batch_.top_left_ = true; }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    static void WriteConnectors(ImGuiNodesJsonWriter &writer, const std::vector<ImGuiNodesConnectionDesc> &connectors)
+    {
+        writer.BeginArray();
+
+        for (const ImGuiNodesConnectionDesc &connector : connectors)
+        {
+            writer.BeginObject();
+            writer.Key("name");
+            writer.String(connector.name_);
+            writer.Key("type");
+            writer.Integer(connector.type_);
+            writer.EndObject();
+        }
+
+        writer.EndArray();
+    }
+
+    bool ImGuiNodes::ExportJson(const char *path) const
+    {
+        std::unordered_map<const ImGuiNodesNodeDesc *, uint32_t> desc_indices;
+        std::unordered_map<const ImGuiNodesNode *, uint32_t> node_indices;
+
+        desc_indices.reserve(nodes_desc_.size());
+        node_indices.reserve(nodes_.size());
+
+        for (const ImGuiNodesNodeDesc &desc : nodes_desc_)
+            desc_indices.emplace(&desc, static_cast<uint32_t>(desc_indices.size()));
+
+        for (const ImGuiNodesNode *node : nodes_)
+        {
+            if (0 == desc_indices.count(node->desc_))
+                return false;
+
+            node_indices.emplace(node, static_cast<uint32_t>(node_indices.size()));
+        }
+
+        ImGuiNodesJsonWriter writer;
+        if (!writer.Open(path))
+            return false;
+
+        writer.BeginObject();
+
+        writer.Key("version");
+        writer.Integer(ImGuiNodesJsonVersion);
+
+        writer.Key("view");
+        writer.BeginObject();
+        writer.Key("scroll");
+        writer.BeginArray();
+        writer.Number(scroll_.x);
+        writer.Number(scroll_.y);
+        writer.EndArray();
+        writer.Key("scale");
+        writer.Number(scale_);
+        writer.EndObject();
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        writer.Key("descs");
+        writer.BeginArray();
+
+        for (const ImGuiNodesNodeDesc &desc : nodes_desc_)
+        {
+            writer.BeginObject();
+            writer.Key("name");
+            writer.String(desc.name_);
+            writer.Key("type");
+            writer.Integer(desc.type_);
+            writer.Key("color");
+            writer.BeginArray();
+            writer.Number(desc.color_.Value.x);
+            writer.Number(desc.color_.Value.y);
+            writer.Number(desc.color_.Value.z);
+            writer.Number(desc.color_.Value.w);
+            writer.EndArray();
+            writer.Key("inputs");
+            WriteConnectors(writer, desc.inputs_);
+            writer.Key("outputs");
+            WriteConnectors(writer, desc.outputs_);
+            writer.EndObject();
+        }
+
+        writer.EndArray();
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        writer.Key("nodes");
+        writer.BeginArray();
+
+        for (const ImGuiNodesNode *node : nodes_)
+        {
+            writer.BeginObject();
+            writer.Key("desc");
+            writer.Integer(desc_indices.at(node->desc_));
+            writer.Key("pos");
+            writer.BeginArray();
+            writer.Number(node->area_node_.Min.x);
+            writer.Number(node->area_node_.Min.y);
+            writer.EndArray();
+
+            if (node->name_ != node->desc_->name_)
+            {
+                writer.Key("name");
+                writer.String(node->name_);
+            }
+
+            if (node->state_ & ImGuiNodesNodeStateFlag_Collapsed)
+            {
+                writer.Key("collapsed");
+                writer.Bool(true);
+            }
+
+            if (node->state_ & ImGuiNodesNodeStateFlag_Disabled)
+            {
+                writer.Key("disabled");
+                writer.Bool(true);
+            }
+
+            if (node->state_ & ImGuiNodesNodeStateFlag_Selected)
+            {
+                writer.Key("selected");
+                writer.Bool(true);
+            }
+
+            writer.EndObject();
+        }
+
+        writer.EndArray();
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        writer.Key("edges");
+        writer.BeginArray();
+
+        for (const ImGuiNodesNode *node : nodes_)
+        {
+            for (size_t input_idx = 0; input_idx < node->inputs_.size(); ++input_idx)
+            {
+                const ImGuiNodesInput &input = node->inputs_[input_idx];
+
+                if (nullptr == input.target_ || nullptr == input.output_)
+                    continue;
+
+                writer.BeginArray();
+                writer.Integer(node_indices.at(input.target_));
+                writer.Integer(input.output_ - input.target_->outputs_.data());
+                writer.Integer(node_indices.at(node));
+                writer.Integer(static_cast<int64_t>(input_idx));
+                writer.EndArray();
+            }
+        }
+
+        writer.EndArray();
+
+        writer.EndObject();
+
+        return writer.Close();
+    }
+
+    bool ImGuiNodes::ImportJson(const char *path)
+    {
+        ImGuiNodesJsonImporter importer(*this);
+        ImGuiNodesJsonReader reader;
+
+        if (!reader.Parse(path, importer) || !importer.done_)
+            return false;
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<const ImGuiNodesNodeDesc *, ImGuiNodesNodeDesc *> registered_descs;
+
+        for (std::unique_ptr<ImGuiNodesNodeDesc> &desc : importer.staged_descs_)
+        {
+            AddNodeDesc(std::move(*desc));
+            registered_descs.emplace(desc.get(), FindNodeDesc(desc->name_));
+        }
+
+        if (!registered_descs.empty())
+            for (ImGuiNodesBatchNode &record : importer.batch_.nodes_)
+                if (auto it = registered_descs.find(record.desc_); it != registered_descs.end())
+                    record.desc_ = it->second;
+
+        for (ImGuiNodesNode *node : nodes_)
+            delete node;
+
+        // the listener hears of the import once, with the graph it ends up with
+        Reset();
+        name_pool_.clear();
+
+        state_ = ImGuiNodesState_Default;
+        connection_ = ImVec4();
+
+        BuildBatch(importer.batch_);
+
+        if (importer.has_view_)
+        {
+            scroll_ = importer.scroll_;
+            scale_ = ImClamp(importer.scale_, 0.3f, 3.0f);
+        }
+
+        if (listener_)
+            listener_->OnReset(*this);
+
+        return true;
+    }
+}
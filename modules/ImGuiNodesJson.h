@@ -0,0 +1,138 @@
+#ifndef IMGUI_NODES_JSON_H // !IMGUI_NODES_JSON_H
+#define IMGUI_NODES_JSON_H
+
+#include "ImGuiNodes.h"
+
+#include <stdio.h>
+
+#include <cstdint>
+#include <string>
+
+namespace ImGui
+{
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // ImGuiNodes::ExportJson() document, sections are written and must be read in this order:
+    // {"version":1,"view":{"scroll":[x,y],"scale":s},
+    //  "descs":[{"name":"","type":0,"color":[r,g,b,a],"inputs":[{"name":"","type":0}],"outputs":[]}],
+    //  "nodes":[{"desc":0,"pos":[x,y],"name":"","collapsed":true,"disabled":true,"selected":true}],
+    //  "edges":[[output_node,output_slot,input_node,input_slot]]}
+    // nodes index descs, edges index nodes, optional node fields are omitted when unset
+    constexpr int ImGuiNodesJsonVersion = 1;
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // SAX events of ImGuiNodesJsonReader, returning false stops the parse
+    struct ImGuiNodesJsonHandler
+    {
+        virtual bool Null() { return true; }
+        virtual bool Bool(bool /*value*/) { return true; }
+        virtual bool Number(double /*value*/) { return true; }
+        virtual bool String(std::string_view /*value*/) { return true; }
+        virtual bool Key(std::string_view /*key*/) { return true; }
+        virtual bool BeginObject() { return true; }
+        virtual bool EndObject() { return true; }
+        virtual bool BeginArray() { return true; }
+        virtual bool EndArray() { return true; }
+
+        virtual ~ImGuiNodesJsonHandler() = default;
+    };
+
+    // streaming parser, memory is one read buffer plus the longest string, never the document
+    struct ImGuiNodesJsonReader
+    {
+    public:
+        static constexpr size_t BufferSize = 1 << 16;
+        static constexpr size_t MaxDepth = 64;
+        static constexpr size_t MaxStringSize = 1 << 20;
+
+    private:
+        FILE *file_ = nullptr;
+        std::unique_ptr<char[]> buffer_;
+        const char *cursor_ = nullptr;
+        const char *end_ = nullptr;
+        uint64_t base_ = 0;
+
+        std::string token_;
+
+        bool Refill();
+        int Peek();
+        int SkipWhitespace();
+
+        bool ReadHex(uint32_t &value);
+        bool ReadString();
+        bool ReadNumber(double &value);
+        bool ReadLiteral(const char *literal);
+
+    public:
+        // string_views handed to the handler are only valid during the callback
+        bool Parse(FILE *file, ImGuiNodesJsonHandler &handler);
+        bool Parse(const char *path, ImGuiNodesJsonHandler &handler);
+
+        // bytes consumed so far, after a failed parse this is where it stopped
+        uint64_t GetOffset() const { return base_ + (cursor_ - buffer_.get()); }
+
+        ImGuiNodesJsonReader() : buffer_(new char[BufferSize]) { cursor_ = end_ = buffer_.get(); }
+    };
+
+    // streaming writer, values are buffered and written out in BufferSize chunks
+    struct ImGuiNodesJsonWriter
+    {
+    public:
+        static constexpr size_t BufferSize = 1 << 16;
+        static constexpr int MaxDepth = 64;
+
+    private:
+        FILE *file_ = nullptr;
+        std::unique_ptr<char[]> buffer_;
+        size_t used_ = 0;
+        uint64_t flushed_ = 0;
+        bool failed_ = false;
+
+        int depth_ = 0;
+        uint64_t arrays_ = 0; // bit per depth, set for arrays
+        uint64_t filled_ = 0; // bit per depth, set once the container has an element
+        bool after_key_ = false;
+
+        void Flush();
+        void Put(char c);
+        void Put(const char *data, size_t size);
+        void Separate();
+        void Begin(char c, bool array);
+        void End(char c);
+        void Escaped(std::string_view value);
+
+    public:
+        bool Open(const char *path);
+        // flushes and closes the file, false if any write failed
+        bool Close();
+
+        void BeginObject() { Begin('{', false); }
+        void EndObject() { End('}'); }
+        void BeginArray() { Begin('[', true); }
+        void EndArray() { End(']'); }
+
+        void Key(std::string_view key);
+        void String(std::string_view value);
+        void Integer(int64_t value);
+        void Number(double value);
+        void Number(float value); // shortest text that reads back as the same float
+        void Bool(bool value);
+        void Null();
+
+        uint64_t GetBytesWritten() const { return flushed_ + used_; }
+
+        ImGuiNodesJsonWriter() : buffer_(new char[BufferSize]) {}
+        ImGuiNodesJsonWriter(const ImGuiNodesJsonWriter &) = delete;
+        ImGuiNodesJsonWriter &operator=(const ImGuiNodesJsonWriter &) = delete;
+        ~ImGuiNodesJsonWriter() { Close(); }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+}
+
+#if defined(IMGUI_NODES_HEADER_ONLY)
+#include "ImGuiNodesJson.cc"
+#endif
+
+#endif // !IMGUI_NODES_JSON_H
@@ -0,0 +1,1209 @@
+#include "ImGuiNodesLayout.h"
+
+#include <float.h>
+#include <math.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace ImGui
+{
+    // vertices handled by one worker, below that a thread costs more than it saves
+    constexpr size_t ImGuiNodesLayoutGrain = 16384;
+
+    // workers shared by every layout of the process and kept between calls, the force layout splits every
+    // frame, grows to the most workers asked for at once and joins them at exit
+    struct ImGuiNodesLayoutPool
+    {
+    private:
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::deque<std::function<void()>> tasks_;
+        std::vector<std::thread> workers_;
+        bool quit_ = false;
+
+        void WorkerLoop()
+        {
+            for (;;)
+            {
+                std::function<void()> task;
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    wake_.wait(lock, [this]() { return quit_ || !tasks_.empty(); });
+
+                    if (tasks_.empty())
+                        return;
+
+                    task = std::move(tasks_.front());
+                    tasks_.pop_front();
+                }
+
+                task();
+            }
+        }
+
+    public:
+        static ImGuiNodesLayoutPool &Get()
+        {
+            static ImGuiNodesLayoutPool pool;
+            return pool;
+        }
+
+        void Post(std::function<void()> task, size_t workers)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                while (workers_.size() < workers)
+                    workers_.emplace_back(&ImGuiNodesLayoutPool::WorkerLoop, this);
+
+                tasks_.push_back(std::move(task));
+            }
+
+            wake_.notify_one();
+        }
+
+        ~ImGuiNodesLayoutPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                quit_ = true;
+            }
+
+            wake_.notify_all();
+
+            for (std::thread &worker : workers_)
+                worker.join();
+        }
+    };
+
+    // fn(begin, end) over up to threads chunks, the calling thread takes the first one and the pool the rest
+    template <typename F>
+    static inline void ParallelFor(size_t count, int threads, F &&fn)
+    {
+        const size_t chunks = ImMin(size_t(ImMax(threads, 1)), count);
+
+        if (chunks <= 1)
+        {
+            fn(size_t(0), count);
+            return;
+        }
+
+        const size_t step = (count + chunks - 1) / chunks;
+
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t remaining = (count - 1) / step; // chunks after the first
+
+        for (size_t begin = step; begin < count; begin += step)
+            ImGuiNodesLayoutPool::Get().Post([&, begin]() {
+                fn(begin, ImMin(count, begin + step));
+
+                // notified under the lock, the waiter cannot return and destroy it before
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--remaining == 0)
+                    done.notify_one();
+            }, chunks - 1);
+
+        fn(size_t(0), step);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&remaining]() { return remaining == 0; });
+    }
+
+    // every hardware thread for 0, but no more than there are grains of work
+    static inline int GetLayoutThreads(int threads, size_t items)
+    {
+        if (threads <= 0)
+            threads = int(ImMax(1u, std::thread::hardware_concurrency()));
+
+        return int(ImMin(size_t(threads), ImMax(size_t(1), items / ImGuiNodesLayoutGrain)));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void ImGuiNodesLayeredLayout::BuildIndex(const std::vector<Edge> &edges, size_t vertices, bool by_from, bool edge_indices, std::vector<uint32_t> &offsets, std::vector<uint32_t> &items)
+    {
+        offsets.assign(vertices + 1, 0);
+
+        for (const Edge &edge : edges)
+            ++offsets[(by_from ? edge.from_ : edge.to_) + 1];
+
+        for (size_t vertex_idx = 0; vertex_idx < vertices; ++vertex_idx)
+            offsets[vertex_idx + 1] += offsets[vertex_idx];
+
+        std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+        items.resize(edges.size());
+
+        for (uint32_t edge_idx = 0; edge_idx < edges.size(); ++edge_idx)
+        {
+            const Edge &edge = edges[edge_idx];
+            items[cursors[by_from ? edge.from_ : edge.to_]++] = edge_indices ? edge_idx : (by_from ? edge.to_ : edge.from_);
+        }
+    }
+
+    void ImGuiNodesLayeredLayout::Gather(const ImGuiNodes &nodes)
+    {
+        const std::vector<ImGuiNodesNode *> &graph = nodes.GetNodes();
+
+        nodes_.assign(graph.begin(), graph.end());
+        edges_.clear();
+        sizes_.resize(nodes_.size());
+
+        index_.clear();
+        index_.reserve(nodes_.size());
+
+        for (uint32_t node_idx = 0; node_idx < nodes_.size(); ++node_idx)
+        {
+            index_[nodes_[node_idx]] = node_idx;
+            sizes_[node_idx] = nodes_[node_idx]->area_node_.GetSize();
+        }
+
+        for (uint32_t node_idx = 0; node_idx < nodes_.size(); ++node_idx)
+            for (const ImGuiNodesInput &input : nodes_[node_idx]->inputs_)
+            {
+                if (input.target_ == NULL || input.target_ == nodes_[node_idx])
+                    continue;
+
+                auto source = index_.find(input.target_);
+                if (source != index_.end())
+                    edges_.push_back({source->second, node_idx});
+            }
+    }
+
+    // edges closing a cycle in a depth first search are turned around, sources are searched first so
+    // the edges reversed are the ones pointing back against the flow
+    void ImGuiNodesLayeredLayout::BreakCycles()
+    {
+        const uint32_t count = static_cast<uint32_t>(nodes_.size());
+
+        BuildIndex(edges_, count, true, true, offsets_, adjacent_);
+
+        degrees_.assign(count, 0);
+        for (const Edge &edge : edges_)
+            ++degrees_[edge.to_];
+
+        marks_.assign(count, 0);
+        topo_.clear();
+
+        for (int pass = 0; pass < 2; ++pass)
+            for (uint32_t start = 0; start < count; ++start)
+            {
+                if (marks_[start] || (pass == 0 && degrees_[start] > 0))
+                    continue;
+
+                marks_[start] = 1;
+                stack_.push_back({start, offsets_[start]});
+
+                while (false == stack_.empty())
+                {
+                    Frame &frame = stack_.back();
+
+                    if (frame.cursor_ == offsets_[frame.vertex_ + 1])
+                    {
+                        marks_[frame.vertex_] = 2;
+                        stack_.pop_back();
+                        continue;
+                    }
+
+                    const uint32_t edge_idx = adjacent_[frame.cursor_++];
+                    const uint32_t to = edges_[edge_idx].to_;
+
+                    if (marks_[to] == 1)
+                        topo_.push_back(edge_idx);
+                    else if (marks_[to] == 0)
+                    {
+                        marks_[to] = 1;
+                        stack_.push_back({to, offsets_[to]});
+                    }
+                }
+            }
+
+        for (uint32_t edge_idx : topo_)
+            std::swap(edges_[edge_idx].from_, edges_[edge_idx].to_);
+
+        reversed_ = static_cast<uint32_t>(topo_.size());
+    }
+
+    // longest path from the sources, then in reverse topological order nodes with more outgoing than
+    // incoming edges move up to their closest target, which shortens edges the way network simplex would
+    // for the common case of sources and chains hanging far left, in one linear pass
+    void ImGuiNodesLayeredLayout::AssignLayers()
+    {
+        const uint32_t count = static_cast<uint32_t>(nodes_.size());
+
+        BuildIndex(edges_, count, true, false, offsets_, adjacent_);
+
+        degrees_.assign(count, 0);
+        for (const Edge &edge : edges_)
+            ++degrees_[edge.to_];
+
+        topo_.clear();
+        for (uint32_t vertex = 0; vertex < count; ++vertex)
+            if (degrees_[vertex] == 0)
+                topo_.push_back(vertex);
+
+        for (size_t head = 0; head < topo_.size(); ++head)
+            for (uint32_t edge_idx = offsets_[topo_[head]]; edge_idx < offsets_[topo_[head] + 1]; ++edge_idx)
+                if (--degrees_[adjacent_[edge_idx]] == 0)
+                    topo_.push_back(adjacent_[edge_idx]);
+
+        IM_ASSERT(topo_.size() == count);
+
+        layer_.assign(count, 0);
+
+        for (uint32_t vertex : topo_)
+            for (uint32_t edge_idx = offsets_[vertex]; edge_idx < offsets_[vertex + 1]; ++edge_idx)
+                layer_[adjacent_[edge_idx]] = ImMax(layer_[adjacent_[edge_idx]], layer_[vertex] + 1);
+
+        for (const Edge &edge : edges_)
+            ++degrees_[edge.to_];
+
+        for (size_t topo_idx = topo_.size(); topo_idx-- > 0;)
+        {
+            const uint32_t vertex = topo_[topo_idx];
+            const uint32_t outgoing = offsets_[vertex + 1] - offsets_[vertex];
+
+            if (outgoing <= degrees_[vertex])
+                continue;
+
+            uint32_t closest = UINT32_MAX;
+            for (uint32_t edge_idx = offsets_[vertex]; edge_idx < offsets_[vertex + 1]; ++edge_idx)
+                closest = ImMin(closest, layer_[adjacent_[edge_idx]]);
+
+            layer_[vertex] = closest - 1;
+        }
+
+        uint32_t first = UINT32_MAX, last = 0;
+
+        for (uint32_t layer : layer_)
+        {
+            first = ImMin(first, layer);
+            last = ImMax(last, layer);
+        }
+
+        for (uint32_t &layer : layer_)
+            layer -= first;
+
+        layers_ = count ? last - first + 1 : 0;
+    }
+
+    // edges spanning layers become chains of zero sized dummies, so every segment joins neighbouring layers
+    void ImGuiNodesLayeredLayout::InsertDummies()
+    {
+        segments_.clear();
+        segments_.reserve(edges_.size());
+
+        for (const Edge &edge : edges_)
+        {
+            uint32_t from = edge.from_;
+
+            for (uint32_t layer = layer_[edge.from_] + 1; layer < layer_[edge.to_]; ++layer)
+            {
+                const uint32_t dummy = static_cast<uint32_t>(layer_.size());
+
+                layer_.push_back(layer);
+                sizes_.push_back(ImVec2(0.0f, 0.0f));
+                segments_.push_back({from, dummy});
+                from = dummy;
+            }
+
+            segments_.push_back({from, edge.to_});
+        }
+
+        dummies_ = static_cast<uint32_t>(layer_.size() - nodes_.size());
+
+        BuildIndex(segments_, layer_.size(), false, false, up_offsets_, up_);
+        BuildIndex(segments_, layer_.size(), false, true, up_offsets_, up_segments_);
+        BuildIndex(segments_, layer_.size(), true, false, down_offsets_, down_);
+        BuildIndex(segments_, layer_.size(), true, true, down_offsets_, down_segments_);
+    }
+
+    // vertices enter their layer in depth first order from the left most layers, so connected vertices start close
+    void ImGuiNodesLayeredLayout::InitOrder()
+    {
+        const uint32_t vertices = static_cast<uint32_t>(layer_.size());
+
+        order_offsets_.assign(layers_ + 1, 0);
+        for (uint32_t layer : layer_)
+            ++order_offsets_[layer + 1];
+
+        for (uint32_t layer = 0; layer < layers_; ++layer)
+            order_offsets_[layer + 1] += order_offsets_[layer];
+
+        // by layer first, as the starting points of the search
+        degrees_.assign(order_offsets_.begin(), order_offsets_.end() - 1);
+        best_order_.resize(vertices);
+
+        for (uint32_t vertex = 0; vertex < vertices; ++vertex)
+            best_order_[degrees_[layer_[vertex]]++] = vertex;
+
+        degrees_.assign(order_offsets_.begin(), order_offsets_.end() - 1);
+        order_.resize(vertices);
+        pos_.resize(vertices);
+        marks_.assign(vertices, 0);
+
+        for (uint32_t start : best_order_)
+        {
+            if (marks_[start])
+                continue;
+
+            topo_.assign(1, start);
+
+            while (false == topo_.empty())
+            {
+                const uint32_t vertex = topo_.back();
+                topo_.pop_back();
+
+                if (marks_[vertex])
+                    continue;
+
+                marks_[vertex] = 1;
+                pos_[vertex] = degrees_[layer_[vertex]] - order_offsets_[layer_[vertex]];
+                order_[degrees_[layer_[vertex]]++] = vertex;
+
+                for (uint32_t down_idx = down_offsets_[vertex + 1]; down_idx-- > down_offsets_[vertex];)
+                    if (0 == marks_[down_[down_idx]])
+                        topo_.push_back(down_[down_idx]);
+            }
+        }
+    }
+
+    // orders a layer by the mean position of its neighbours in the layer above when sweeping down or below
+    // when sweeping up, vertices without neighbours keep their relative place, the keys of a wide layer are
+    // computed by several workers
+    void ImGuiNodesLayeredLayout::SortLayer(uint32_t layer, bool downward)
+    {
+        const uint32_t begin = order_offsets_[layer];
+        const uint32_t end = order_offsets_[layer + 1];
+
+        const std::vector<uint32_t> &offsets = downward ? up_offsets_ : down_offsets_;
+        const std::vector<uint32_t> &neighbours = downward ? up_ : down_;
+
+        const uint32_t other = downward ? layer - 1 : layer + 1;
+        const float ratio = float(order_offsets_[other + 1] - order_offsets_[other]) / float(end - begin);
+
+        ParallelFor(end - begin, GetLayoutThreads(threads_, end - begin), [&](size_t first, size_t last) {
+            for (size_t order_idx = begin + first; order_idx < begin + last; ++order_idx)
+            {
+                const uint32_t vertex = order_[order_idx];
+                const uint32_t count = offsets[vertex + 1] - offsets[vertex];
+
+                float sum = 0.0f;
+                for (uint32_t neighbour_idx = offsets[vertex]; neighbour_idx < offsets[vertex + 1]; ++neighbour_idx)
+                    sum += float(pos_[neighbours[neighbour_idx]]);
+
+                keys_[order_idx] = {count ? sum / float(count) : float(pos_[vertex]) * ratio, vertex};
+            }
+        });
+
+        std::sort(keys_.begin() + begin, keys_.begin() + end, [this](const std::pair<float, uint32_t> &a, const std::pair<float, uint32_t> &b) {
+            return a.first < b.first || (a.first == b.first && pos_[a.second] < pos_[b.second]);
+        });
+
+        for (uint32_t order_idx = begin; order_idx < end; ++order_idx)
+        {
+            order_[order_idx] = keys_[order_idx].second;
+            pos_[keys_[order_idx].second] = order_idx - begin;
+        }
+    }
+
+    // Barth, Juenger and Mutzel, the inversions of the segments between two layers are counted with an
+    // accumulator tree in E log V, the pairs of layers are independent and split between the workers
+    size_t ImGuiNodesLayeredLayout::CountCrossings()
+    {
+        if (layers_ < 2)
+            return 0;
+
+        crossings_by_layer_.assign(layers_ - 1, 0);
+
+        ParallelFor(layers_ - 1, GetLayoutThreads(threads_, layer_.size()), [this](size_t first, size_t last) {
+            std::vector<uint32_t> sequence;
+            std::vector<size_t> tree;
+
+            for (size_t layer = first; layer < last; ++layer)
+            {
+                sequence.clear();
+
+                for (uint32_t order_idx = order_offsets_[layer]; order_idx < order_offsets_[layer + 1]; ++order_idx)
+                {
+                    const uint32_t vertex = order_[order_idx];
+                    const size_t start = sequence.size();
+
+                    for (uint32_t down_idx = down_offsets_[vertex]; down_idx < down_offsets_[vertex + 1]; ++down_idx)
+                        sequence.push_back(pos_[down_[down_idx]]);
+
+                    std::sort(sequence.begin() + start, sequence.end());
+                }
+
+                size_t leaves = 1;
+                while (leaves < order_offsets_[layer + 2] - order_offsets_[layer + 1])
+                    leaves <<= 1;
+
+                tree.assign(2 * leaves - 1, 0);
+
+                size_t crossings = 0;
+
+                for (uint32_t pos : sequence)
+                {
+                    size_t tree_idx = pos + leaves - 1;
+                    ++tree[tree_idx];
+
+                    while (tree_idx > 0)
+                    {
+                        if (tree_idx % 2)
+                            crossings += tree[tree_idx + 1];
+
+                        tree_idx = (tree_idx - 1) / 2;
+                        ++tree[tree_idx];
+                    }
+                }
+
+                crossings_by_layer_[layer] = crossings;
+            }
+        });
+
+        return std::accumulate(crossings_by_layer_.begin(), crossings_by_layer_.end(), size_t(0));
+    }
+
+    // type 1 conflicts, segments between real vertices crossing an inner segment between two dummies,
+    // the inner segments win so long edges stay straight
+    void ImGuiNodesLayeredLayout::FindConflicts()
+    {
+        conflicts_.assign(segments_.size(), 0);
+
+        for (uint32_t layer = 1; layer < layers_; ++layer)
+        {
+            const uint32_t begin = order_offsets_[layer];
+            const uint32_t end = order_offsets_[layer + 1];
+
+            uint32_t k0 = 0;
+            uint32_t scan = begin;
+
+            for (uint32_t order_idx = begin; order_idx < end; ++order_idx)
+            {
+                const uint32_t vertex = order_[order_idx];
+
+                uint32_t inner = UINT32_MAX;
+                if (IsDummy(vertex) && up_offsets_[vertex] < up_offsets_[vertex + 1] && IsDummy(up_[up_offsets_[vertex]]))
+                    inner = up_[up_offsets_[vertex]];
+
+                if (inner == UINT32_MAX && order_idx + 1 != end)
+                    continue;
+
+                const uint32_t k1 = inner != UINT32_MAX ? pos_[inner] : order_offsets_[layer] - order_offsets_[layer - 1];
+
+                for (; scan <= order_idx; ++scan)
+                {
+                    const uint32_t scanned = order_[scan];
+
+                    for (uint32_t up_idx = up_offsets_[scanned]; up_idx < up_offsets_[scanned + 1]; ++up_idx)
+                    {
+                        const uint32_t up = up_[up_idx];
+
+                        if ((pos_[up] < k0 || k1 < pos_[up]) && !(IsDummy(up) && IsDummy(scanned)))
+                            conflicts_[up_segments_[up_idx]] = 1;
+                    }
+                }
+
+                k0 = k1;
+            }
+        }
+    }
+
+    // vertices join the block of a median neighbour in the previous layer of the sweep, each block is one
+    // straight row, blocks of a layer keep their order so the block graph stays acyclic
+    void ImGuiNodesLayeredLayout::Align(int direction)
+    {
+        Alignment &alignment = alignments_[direction];
+
+        const bool upward = direction < 2;
+        const bool left = direction % 2 == 0;
+
+        const std::vector<uint32_t> &offsets = upward ? up_offsets_ : down_offsets_;
+        const std::vector<uint32_t> &neighbours = upward ? up_ : down_;
+        const std::vector<uint32_t> &segments = upward ? up_segments_ : down_segments_;
+
+        alignment.root_.resize(layer_.size());
+        alignment.align_.resize(layer_.size());
+        std::iota(alignment.root_.begin(), alignment.root_.end(), 0u);
+        std::iota(alignment.align_.begin(), alignment.align_.end(), 0u);
+
+        for (uint32_t layer_idx = 0; layer_idx < layers_; ++layer_idx)
+        {
+            const uint32_t layer = upward ? layer_idx : layers_ - 1 - layer_idx;
+            const uint32_t begin = order_offsets_[layer];
+            const uint32_t end = order_offsets_[layer + 1];
+
+            int64_t previous = -1;
+
+            for (uint32_t order_idx = 0; order_idx < end - begin; ++order_idx)
+            {
+                const uint32_t vertex = order_[left ? begin + order_idx : end - 1 - order_idx];
+                const uint32_t count = offsets[vertex + 1] - offsets[vertex];
+
+                if (0 == count)
+                    continue;
+
+                const uint32_t other = upward ? layer - 1 : layer + 1;
+                const uint32_t other_size = order_offsets_[other + 1] - order_offsets_[other];
+
+                auto position = [&](uint32_t neighbour) { return int64_t(left ? pos_[neighbour] : other_size - 1 - pos_[neighbour]); };
+
+                // indices into the neighbours, so the segment of the median is at hand
+                alignment.neighbours_.resize(count);
+                std::iota(alignment.neighbours_.begin(), alignment.neighbours_.end(), offsets[vertex]);
+                std::sort(alignment.neighbours_.begin(), alignment.neighbours_.end(), [&](uint32_t a, uint32_t b) { return position(neighbours[a]) < position(neighbours[b]); });
+
+                for (uint32_t median = (count - 1) / 2; median <= count / 2; ++median)
+                {
+                    const uint32_t neighbour_idx = alignment.neighbours_[median];
+                    const uint32_t neighbour = neighbours[neighbour_idx];
+
+                    if (alignment.align_[vertex] != vertex || previous >= position(neighbour))
+                        continue;
+
+                    if (conflicts_[segments[neighbour_idx]])
+                        continue;
+
+                    alignment.align_[neighbour] = vertex;
+                    alignment.align_[vertex] = alignment.root_[vertex] = alignment.root_[neighbour];
+                    previous = position(neighbour);
+                }
+            }
+        }
+    }
+
+    // blocks are placed as far left as their left neighbours allow in topological order of the block
+    // graph, then pulled right towards their right neighbours, right aligned passes run mirrored
+    void ImGuiNodesLayeredLayout::Compact(int direction)
+    {
+        Alignment &alignment = alignments_[direction];
+
+        const bool left = direction % 2 == 0;
+        const uint32_t vertices = static_cast<uint32_t>(layer_.size());
+
+        alignment.blocks_.clear();
+        alignment.separations_.clear();
+
+        for (uint32_t layer = 0; layer < layers_; ++layer)
+        {
+            const uint32_t begin = order_offsets_[layer];
+            const uint32_t end = order_offsets_[layer + 1];
+
+            for (uint32_t order_idx = 1; order_idx < end - begin; ++order_idx)
+            {
+                const uint32_t previous = order_[left ? begin + order_idx - 1 : end - order_idx];
+                const uint32_t vertex = order_[left ? begin + order_idx : end - 1 - order_idx];
+
+                float separation = (sizes_[previous].y + sizes_[vertex].y) * 0.5f;
+                separation += (IsDummy(previous) ? edge_spacing_ : node_spacing_) * 0.5f;
+                separation += (IsDummy(vertex) ? edge_spacing_ : node_spacing_) * 0.5f;
+
+                alignment.blocks_.push_back({alignment.root_[previous], alignment.root_[vertex]});
+                alignment.separations_.push_back(separation);
+            }
+        }
+
+        BuildIndex(alignment.blocks_, vertices, false, true, alignment.in_offsets_, alignment.in_);
+        BuildIndex(alignment.blocks_, vertices, true, true, alignment.out_offsets_, alignment.out_);
+
+        alignment.degrees_.resize(vertices);
+        alignment.topo_.clear();
+
+        for (uint32_t vertex = 0; vertex < vertices; ++vertex)
+        {
+            alignment.degrees_[vertex] = alignment.in_offsets_[vertex + 1] - alignment.in_offsets_[vertex];
+
+            if (alignment.root_[vertex] == vertex && alignment.degrees_[vertex] == 0)
+                alignment.topo_.push_back(vertex);
+        }
+
+        for (size_t head = 0; head < alignment.topo_.size(); ++head)
+        {
+            const uint32_t block = alignment.topo_[head];
+
+            for (uint32_t out_idx = alignment.out_offsets_[block]; out_idx < alignment.out_offsets_[block + 1]; ++out_idx)
+                if (--alignment.degrees_[alignment.blocks_[alignment.out_[out_idx]].to_] == 0)
+                    alignment.topo_.push_back(alignment.blocks_[alignment.out_[out_idx]].to_);
+        }
+
+        alignment.x_.assign(vertices, 0.0f);
+
+        for (uint32_t block : alignment.topo_)
+            for (uint32_t in_idx = alignment.in_offsets_[block]; in_idx < alignment.in_offsets_[block + 1]; ++in_idx)
+            {
+                const uint32_t edge_idx = alignment.in_[in_idx];
+                alignment.x_[block] = ImMax(alignment.x_[block], alignment.x_[alignment.blocks_[edge_idx].from_] + alignment.separations_[edge_idx]);
+            }
+
+        for (size_t topo_idx = alignment.topo_.size(); topo_idx-- > 0;)
+        {
+            const uint32_t block = alignment.topo_[topo_idx];
+
+            if (alignment.out_offsets_[block] == alignment.out_offsets_[block + 1])
+                continue;
+
+            float closest = FLT_MAX;
+            for (uint32_t out_idx = alignment.out_offsets_[block]; out_idx < alignment.out_offsets_[block + 1]; ++out_idx)
+            {
+                const uint32_t edge_idx = alignment.out_[out_idx];
+                closest = ImMin(closest, alignment.x_[alignment.blocks_[edge_idx].to_] - alignment.separations_[edge_idx]);
+            }
+
+            alignment.x_[block] = ImMax(alignment.x_[block], closest);
+        }
+
+        for (uint32_t vertex = 0; vertex < vertices; ++vertex)
+            alignment.x_[vertex] = alignment.x_[alignment.root_[vertex]];
+
+        if (false == left)
+            for (float &x : alignment.x_)
+                x = -x;
+    }
+
+    // the four passes are independent and run on their own workers, the narrowest one anchors the others
+    // and every vertex takes the mean of its two middle candidates
+    void ImGuiNodesLayeredLayout::AssignCoordinates()
+    {
+        const uint32_t vertices = static_cast<uint32_t>(layer_.size());
+
+        FindConflicts();
+
+        ParallelFor(4, GetLayoutThreads(threads_, size_t(vertices) * 4), [this](size_t first, size_t last) {
+            for (size_t direction = first; direction < last; ++direction)
+            {
+                Align(int(direction));
+                Compact(int(direction));
+            }
+        });
+
+        float min[4], max[4];
+        int narrowest = 0;
+
+        for (int direction = 0; direction < 4; ++direction)
+        {
+            min[direction] = FLT_MAX;
+            max[direction] = -FLT_MAX;
+
+            for (uint32_t vertex = 0; vertex < vertices; ++vertex)
+            {
+                const float x = alignments_[direction].x_[vertex];
+                min[direction] = ImMin(min[direction], x - sizes_[vertex].y * 0.5f);
+                max[direction] = ImMax(max[direction], x + sizes_[vertex].y * 0.5f);
+            }
+
+            if (max[direction] - min[direction] < max[narrowest] - min[narrowest])
+                narrowest = direction;
+        }
+
+        for (int direction = 0; direction < 4; ++direction)
+        {
+            const float shift = direction % 2 == 0 ? min[narrowest] - min[direction] : max[narrowest] - max[direction];
+
+            for (float &x : alignments_[direction].x_)
+                x += shift;
+        }
+
+        y_.resize(vertices);
+
+        for (uint32_t vertex = 0; vertex < vertices; ++vertex)
+        {
+            float candidates[4];
+            for (int direction = 0; direction < 4; ++direction)
+                candidates[direction] = alignments_[direction].x_[vertex];
+
+            std::sort(candidates, candidates + 4);
+            y_[vertex] = (candidates[1] + candidates[2]) * 0.5f;
+        }
+    }
+
+    // layers are columns as wide as their widest node, nodes are centered in their column
+    void ImGuiNodesLayeredLayout::Place()
+    {
+        std::vector<float> columns(layers_ + 1, 0.0f);
+
+        for (uint32_t node_idx = 0; node_idx < nodes_.size(); ++node_idx)
+            columns[layer_[node_idx] + 1] = ImMax(columns[layer_[node_idx] + 1], sizes_[node_idx].x);
+
+        for (uint32_t layer = 0; layer < layers_; ++layer)
+            columns[layer + 1] += columns[layer] + layer_spacing_;
+
+        positions_.resize(nodes_.size());
+
+        for (uint32_t node_idx = 0; node_idx < nodes_.size(); ++node_idx)
+        {
+            const uint32_t layer = layer_[node_idx];
+            const float width = columns[layer + 1] - columns[layer] - layer_spacing_;
+
+            positions_[node_idx].x = columns[layer] + (width - sizes_[node_idx].x) * 0.5f;
+            positions_[node_idx].y = y_[node_idx] - sizes_[node_idx].y * 0.5f;
+        }
+    }
+
+    void ImGuiNodesLayeredLayout::Apply(ImGuiNodes &nodes)
+    {
+        layers_ = 0;
+        dummies_ = 0;
+        reversed_ = 0;
+        crossings_ = 0;
+
+        Gather(nodes);
+
+        if (nodes_.empty())
+            return;
+
+        // the layout keeps the top left corner of the graph where it was
+        ImVec2 origin(FLT_MAX, FLT_MAX);
+        for (const ImGuiNodesNode *node : nodes_)
+            origin = ImMin(origin, node->area_node_.Min);
+
+        BreakCycles();
+        AssignLayers();
+        InsertDummies();
+        InitOrder();
+
+        keys_.resize(layer_.size());
+
+        crossings_ = CountCrossings();
+        best_order_ = order_;
+
+        for (int sweep = 0; sweep < sweeps_ && crossings_ > 0; ++sweep)
+        {
+            if (sweep % 2 == 0)
+                for (uint32_t layer = 1; layer < layers_; ++layer)
+                    SortLayer(layer, true);
+            else
+                for (uint32_t layer = layers_ - 1; layer-- > 0;)
+                    SortLayer(layer, false);
+
+            const size_t crossings = CountCrossings();
+
+            if (crossings < crossings_)
+            {
+                crossings_ = crossings;
+                best_order_ = order_;
+            }
+        }
+
+        order_.swap(best_order_);
+
+        for (uint32_t layer = 0; layer < layers_; ++layer)
+            for (uint32_t order_idx = order_offsets_[layer]; order_idx < order_offsets_[layer + 1]; ++order_idx)
+                pos_[order_[order_idx]] = order_idx - order_offsets_[layer];
+
+        AssignCoordinates();
+        Place();
+
+        ImVec2 min(FLT_MAX, FLT_MAX);
+        for (const ImVec2 &position : positions_)
+            min = ImMin(min, position);
+
+        for (ImVec2 &position : positions_)
+            position += origin - min;
+
+        nodes.MoveNodes(nodes_.data(), positions_.data(), positions_.size());
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // cells below this depth keep every body reaching them, so bodies on one spot do not split forever
+    constexpr int ImGuiNodesForceDepth = 24;
+
+    // a node freed and another one allocated at its address differ by id
+    uint64_t ImGuiNodesForceLayout::HashGraph(const std::vector<ImGuiNodesNode *> &nodes)
+    {
+        uint64_t hash = 14695981039346656037ull;
+
+        for (const ImGuiNodesNode *node : nodes)
+        {
+            hash = (hash ^ node->id_) * 1099511628211ull;
+
+            for (const ImGuiNodesInput &input : node->inputs_)
+                hash = (hash ^ reinterpret_cast<uintptr_t>(input.target_)) * 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    // the graph is compared every step, nodes or links changed by the user or a pager are picked up
+    // before an index goes stale, the iteration in progress starts over
+    void ImGuiNodesForceLayout::Sync(const ImGuiNodes &nodes)
+    {
+        const std::vector<ImGuiNodesNode *> &graph = nodes.GetNodes();
+
+        if (nodes.GetGeneration() == generation_ && graph.size() == nodes_.size() && std::equal(graph.begin(), graph.end(), nodes_.begin()) && HashGraph(graph) == graph_)
+            return;
+
+        Gather(nodes);
+        cursor_ = 0;
+    }
+
+    void ImGuiNodesForceLayout::Gather(const ImGuiNodes &nodes)
+    {
+        const std::vector<ImGuiNodesNode *> &graph = nodes.GetNodes();
+
+        // moves of the nodes still there are kept for the undo step, by id as the old nodes may be freed,
+        // none of them are left once the graph was cleared or loaded
+        std::unordered_map<uint32_t, ImVec2> moved;
+        if (nodes.GetGeneration() == generation_)
+            for (uint32_t node_idx = 0; node_idx < ids_.size(); ++node_idx)
+                if (moved_[node_idx].x != 0.0f || moved_[node_idx].y != 0.0f)
+                    moved[ids_[node_idx]] = moved_[node_idx];
+
+        nodes_.assign(graph.begin(), graph.end());
+        graph_ = HashGraph(graph);
+        generation_ = nodes.GetGeneration();
+
+        const uint32_t count = static_cast<uint32_t>(nodes_.size());
+
+        index_.clear();
+        index_.reserve(count);
+        ids_.resize(count);
+        moved_.assign(count, ImVec2(0.0f, 0.0f));
+
+        for (uint32_t node_idx = 0; node_idx < count; ++node_idx)
+        {
+            index_[nodes_[node_idx]] = node_idx;
+            ids_[node_idx] = nodes_[node_idx]->id_;
+
+            if (moved.empty())
+                continue;
+
+            auto found = moved.find(ids_[node_idx]);
+            if (found != moved.end())
+                moved_[node_idx] = found->second;
+        }
+
+        // links pull both ends, so the adjacency holds every link twice
+        offsets_.assign(count + 1, 0);
+
+        for (uint32_t node_idx = 0; node_idx < count; ++node_idx)
+            for (const ImGuiNodesInput &input : nodes_[node_idx]->inputs_)
+            {
+                if (input.target_ == NULL || input.target_ == nodes_[node_idx])
+                    continue;
+
+                auto source = index_.find(input.target_);
+                if (source == index_.end())
+                    continue;
+
+                ++offsets_[source->second + 1];
+                ++offsets_[node_idx + 1];
+            }
+
+        for (uint32_t node_idx = 0; node_idx < count; ++node_idx)
+            offsets_[node_idx + 1] += offsets_[node_idx];
+
+        std::vector<uint32_t> cursors(offsets_.begin(), offsets_.end() - 1);
+        neighbours_.resize(offsets_[count]);
+
+        for (uint32_t node_idx = 0; node_idx < count; ++node_idx)
+            for (const ImGuiNodesInput &input : nodes_[node_idx]->inputs_)
+            {
+                if (input.target_ == NULL || input.target_ == nodes_[node_idx])
+                    continue;
+
+                auto source = index_.find(input.target_);
+                if (source == index_.end())
+                    continue;
+
+                neighbours_[cursors[source->second]++] = node_idx;
+                neighbours_[cursors[node_idx]++] = source->second;
+            }
+
+        positions_.resize(count);
+        forces_.resize(count);
+        fixed_.resize(count);
+    }
+
+    void ImGuiNodesForceLayout::BuildTree()
+    {
+        ImVec2 min(FLT_MAX, FLT_MAX), max(-FLT_MAX, -FLT_MAX);
+
+        for (const ImVec2 &position : positions_)
+        {
+            min = ImMin(min, position);
+            max = ImMax(max, position);
+        }
+
+        cells_.clear();
+        cells_.push_back({(min + max) * 0.5f, ImMax(max.x - min.x, max.y - min.y) * 0.5f + 1.0f, 0.0f, ImVec2(0.0f, 0.0f), UINT32_MAX, UINT32_MAX});
+
+        for (uint32_t body = 0; body < positions_.size(); ++body)
+        {
+            const ImVec2 position = positions_[body];
+
+            uint32_t cell_idx = 0;
+
+            for (int depth = 0;; ++depth)
+            {
+                Cell &cell = cells_[cell_idx];
+                cell.mass_ += 1.0f;
+                cell.sum_ += position;
+
+                if (cell.first_ != UINT32_MAX)
+                {
+                    cell_idx = cell.first_ + (position.x >= cell.center_.x) + (position.y >= cell.center_.y) * 2;
+                    continue;
+                }
+
+                if (cell.mass_ == 1.0f)
+                {
+                    cell.body_ = body;
+                    break;
+                }
+
+                if (depth >= ImGuiNodesForceDepth)
+                    break;
+
+                // a leaf taking its second body splits and hands the first one down
+                const uint32_t first = static_cast<uint32_t>(cells_.size());
+                const uint32_t resident = cell.body_;
+                const ImVec2 center = cell.center_;
+                const float half = cell.half_ * 0.5f;
+
+                cell.first_ = first;
+                cell.body_ = UINT32_MAX;
+
+                for (int child = 0; child < 4; ++child)
+                {
+                    const ImVec2 offset((child & 1) ? half : -half, (child & 2) ? half : -half);
+                    cells_.push_back({center + offset, half, 0.0f, ImVec2(0.0f, 0.0f), UINT32_MAX, UINT32_MAX});
+                }
+
+                const ImVec2 resident_position = positions_[resident];
+                Cell &moved = cells_[first + (resident_position.x >= center.x) + (resident_position.y >= center.y) * 2];
+                moved.mass_ = 1.0f;
+                moved.sum_ = resident_position;
+                moved.body_ = resident;
+
+                cell_idx = first + (position.x >= center.x) + (position.y >= center.y) * 2;
+            }
+        }
+
+        for (Cell &cell : cells_)
+            if (cell.mass_ > 0.0f)
+                cell.sum_ /= cell.mass_;
+    }
+
+    // repulsion k^2 / d from the tree, springs d^2 / k along the links and gravity towards the center of mass
+    void ImGuiNodesForceLayout::Push(size_t first, size_t last)
+    {
+        const float k2 = ideal_length_ * ideal_length_;
+        const float theta2 = theta_ * theta_;
+        const ImVec2 center = cells_[0].sum_;
+
+        uint32_t stack[ImGuiNodesForceDepth * 3 + 8];
+
+        for (size_t body = first; body < last; ++body)
+        {
+            if (fixed_[body])
+            {
+                forces_[body] = ImVec2(0.0f, 0.0f);
+                continue;
+            }
+
+            const ImVec2 position = positions_[body];
+            ImVec2 force(0.0f, 0.0f);
+
+            int top = 0;
+            stack[top++] = 0;
+
+            while (top > 0)
+            {
+                const Cell &cell = cells_[stack[--top]];
+
+                if (cell.mass_ == 0.0f)
+                    continue;
+
+                ImVec2 delta = position - cell.sum_;
+                float distance2 = delta.x * delta.x + delta.y * delta.y;
+                float mass = cell.mass_;
+
+                if (cell.first_ != UINT32_MAX)
+                {
+                    const float size = cell.half_ * 2.0f;
+
+                    if (size * size >= theta2 * distance2)
+                    {
+                        for (uint32_t child = 0; child < 4; ++child)
+                            stack[top++] = cell.first_ + child;
+
+                        continue;
+                    }
+                }
+                else if (distance2 < 1e-4f)
+                {
+                    // the leaf of the body itself, others on the same spot push it along a direction of its own
+                    mass -= 1.0f;
+                    if (mass <= 0.0f)
+                        continue;
+
+                    const float angle = float(body % 4096) * 2.39996323f;
+                    delta = ImVec2(cosf(angle), sinf(angle));
+                    distance2 = 1.0f;
+                }
+
+                force += delta * (k2 * mass / distance2);
+            }
+
+            for (uint32_t neighbour_idx = offsets_[body]; neighbour_idx < offsets_[body + 1]; ++neighbour_idx)
+            {
+                const ImVec2 delta = positions_[neighbours_[neighbour_idx]] - position;
+                force += delta * (sqrtf(delta.x * delta.x + delta.y * delta.y) / ideal_length_);
+            }
+
+            force += (center - position) * gravity_;
+            forces_[body] = force;
+        }
+    }
+
+    // every body moves along its force by at most the temperature and the nodes follow right away
+    void ImGuiNodesForceLayout::Advance()
+    {
+        for (uint32_t body = 0; body < nodes_.size(); ++body)
+        {
+            const ImVec2 force = forces_[body];
+            const float length = sqrtf(force.x * force.x + force.y * force.y);
+
+            if (fixed_[body] || !(length > 0.0f))
+                continue;
+
+            const ImVec2 step = force * (ImMin(length, temperature_) / length);
+
+            positions_[body] += step;
+            moved_[body] += step;
+            nodes_[body]->TranslateNode(step);
+        }
+
+        temperature_ *= cooling_;
+        ++iteration_;
+        cursor_ = 0;
+    }
+
+    // the nodes go back to where they started and move again through the editor, which records the step
+    void ImGuiNodesForceLayout::Commit(ImGuiNodes &nodes)
+    {
+        std::vector<ImGuiNodesNode *> moved;
+        std::vector<ImVec2> positions;
+
+        for (uint32_t node_idx = 0; node_idx < nodes_.size(); ++node_idx)
+        {
+            if (moved_[node_idx].x == 0.0f && moved_[node_idx].y == 0.0f)
+                continue;
+
+            nodes_[node_idx]->TranslateNode(ImVec2(0.0f, 0.0f) - moved_[node_idx]);
+
+            moved.push_back(nodes_[node_idx]);
+            positions.push_back(nodes_[node_idx]->area_node_.Min + moved_[node_idx]);
+        }
+
+        nodes.MoveNodes(moved.data(), positions.data(), moved.size());
+
+        running_ = false;
+        cursor_ = 0;
+        moved_.assign(nodes_.size(), ImVec2(0.0f, 0.0f));
+    }
+
+    void ImGuiNodesForceLayout::Start(ImGuiNodes &nodes)
+    {
+        if (running_)
+            Stop(nodes);
+
+        nodes_.clear();
+        ids_.clear();
+        moved_.clear();
+        Gather(nodes);
+
+        running_ = true;
+        iteration_ = 0;
+        cursor_ = 0;
+        temperature_ = ImMax(ideal_length_, ideal_length_ * sqrtf(float(nodes_.size())) * 0.5f);
+    }
+
+    bool ImGuiNodesForceLayout::Step(ImGuiNodes &nodes, double milliseconds)
+    {
+        if (false == running_)
+            return false;
+
+        Sync(nodes);
+
+        if (nodes_.empty())
+        {
+            Commit(nodes);
+            return false;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        auto elapsed = [start]() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+
+        // the clock is checked between chunks of bodies, the tree of an iteration is built in one go
+        const int threads = GetLayoutThreads(threads_, nodes_.size());
+        const size_t chunk = size_t(2048) * threads;
+
+        do
+        {
+            if (cursor_ == 0)
+            {
+                const ImGuiNodesNode *dragged = nodes.GetDraggedNode();
+
+                for (uint32_t node_idx = 0; node_idx < nodes_.size(); ++node_idx)
+                {
+                    const ImGuiNodesNode *node = nodes_[node_idx];
+
+                    positions_[node_idx] = node->area_node_.GetCenter();
+                    fixed_[node_idx] = node == dragged || (node->state_ & ImGuiNodesNodeStateFlag_Selected) || (false == pinned_.empty() && pinned_.count(node->id_));
+                }
+
+                BuildTree();
+            }
+
+            while (cursor_ < nodes_.size())
+            {
+                const size_t first = cursor_;
+                const size_t last = ImMin(nodes_.size(), first + chunk);
+
+                ParallelFor(last - first, threads, [this, first](size_t begin, size_t end) { Push(first + begin, first + end); });
+                cursor_ = last;
+
+                if (cursor_ < nodes_.size() && elapsed() >= milliseconds)
+                    return true;
+            }
+
+            Advance();
+
+            if (temperature_ < 1.0f || iteration_ >= max_iterations_)
+            {
+                Commit(nodes);
+                return false;
+            }
+        } while (elapsed() < milliseconds);
+
+        return true;
+    }
+
+    void ImGuiNodesForceLayout::Stop(ImGuiNodes &nodes)
+    {
+        if (false == running_)
+            return;
+
+        Sync(nodes);
+        Commit(nodes);
+    }
+
+    void ImGuiNodesForceLayout::Pin(const ImGuiNodesNode *node, bool pinned)
+    {
+        if (pinned)
+            pinned_.insert(node->id_);
+        else
+            pinned_.erase(node->id_);
+    }
+}
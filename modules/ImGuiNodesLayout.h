@@ -0,0 +1,232 @@
+#ifndef IMGUI_NODES_LAYOUT_H // !IMGUI_NODES_LAYOUT_H
+#define IMGUI_NODES_LAYOUT_H
+
+#include "ImGuiNodes.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ImGui
+{
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // Sugiyama layout of the editor graph from its connections, outputs flow left to right in layers:
+    // back edges of a depth first search are reversed, nodes take their longest path layer and sources are
+    // pulled towards their targets, edges spanning layers get dummy nodes, barycenter sweeps keep the order
+    // with the fewest crossings and Brandes-Koepf places the nodes inside their layer
+    // every node is placed once however many paths reach it, no pass recurses and all are linear or n log n
+    struct ImGuiNodesLayeredLayout
+    {
+    private:
+        struct Edge
+        {
+            uint32_t from_;
+            uint32_t to_;
+        };
+
+        struct Frame
+        {
+            uint32_t vertex_;
+            uint32_t cursor_;
+        };
+
+        // one of the four Brandes-Koepf passes, up or down the layers and aligned to the left or right
+        struct Alignment
+        {
+            std::vector<uint32_t> root_;
+            std::vector<uint32_t> align_;
+            std::vector<float> x_;
+
+            // block graph, edges between the roots of neighbours in a layer
+            std::vector<Edge> blocks_;
+            std::vector<float> separations_;
+            std::vector<uint32_t> in_offsets_;
+            std::vector<uint32_t> in_;
+            std::vector<uint32_t> out_offsets_;
+            std::vector<uint32_t> out_;
+            std::vector<uint32_t> degrees_;
+            std::vector<uint32_t> topo_;
+
+            std::vector<uint32_t> neighbours_;
+        };
+
+        float layer_spacing_ = 80.0f;
+        float node_spacing_ = 20.0f;
+        float edge_spacing_ = 10.0f;
+        int sweeps_ = 8;
+        int threads_ = 0;
+
+        // vertices are the nodes followed by the dummies
+        std::vector<ImGuiNodesNode *> nodes_;
+        std::unordered_map<const ImGuiNodesNode *, uint32_t> index_;
+        std::vector<Edge> edges_;
+        std::vector<ImVec2> sizes_;
+
+        std::vector<uint32_t> offsets_;  // outgoing edges of the nodes
+        std::vector<uint32_t> adjacent_; // edge indices
+        std::vector<uint32_t> degrees_;
+        std::vector<uint8_t> marks_;
+        std::vector<Frame> stack_;
+        std::vector<uint32_t> topo_;
+
+        std::vector<uint32_t> layer_;
+        std::vector<Edge> segments_;
+        std::vector<uint32_t> up_offsets_;
+        std::vector<uint32_t> up_;          // vertices in the layer before
+        std::vector<uint32_t> up_segments_; // and the segments leading there
+        std::vector<uint32_t> down_offsets_;
+        std::vector<uint32_t> down_;
+        std::vector<uint32_t> down_segments_;
+
+        // vertices by layer, pos_ is the index inside the layer
+        std::vector<uint32_t> order_offsets_;
+        std::vector<uint32_t> order_;
+        std::vector<uint32_t> best_order_;
+        std::vector<uint32_t> pos_;
+        std::vector<std::pair<float, uint32_t>> keys_;
+        std::vector<size_t> crossings_by_layer_;
+
+        std::vector<uint8_t> conflicts_; // by segment
+        Alignment alignments_[4];
+        std::vector<float> y_;
+        std::vector<ImVec2> positions_;
+
+        uint32_t layers_ = 0;
+        uint32_t dummies_ = 0;
+        uint32_t reversed_ = 0;
+        size_t crossings_ = 0;
+
+        // counting sort of the edges by one end, into the other ends or the edge indices
+        static void BuildIndex(const std::vector<Edge> &edges, size_t vertices, bool by_from, bool edge_indices, std::vector<uint32_t> &offsets, std::vector<uint32_t> &items);
+
+        bool IsDummy(uint32_t vertex) const { return vertex >= nodes_.size(); }
+
+        void Gather(const ImGuiNodes &nodes);
+        void BreakCycles();
+        void AssignLayers();
+        void InsertDummies();
+        void InitOrder();
+        void SortLayer(uint32_t layer, bool downward);
+        size_t CountCrossings();
+        void FindConflicts();
+        void Align(int direction);
+        void Compact(int direction);
+        void AssignCoordinates();
+        void Place();
+
+    public:
+        // moves every node of the editor as one undo step, of a paged graph only the loaded tiles
+        void Apply(ImGuiNodes &nodes);
+
+        // world units between the right and left sides of neighbouring layers
+        void SetLayerSpacing(float spacing) { layer_spacing_ = spacing; }
+        // world units between nodes of a layer, edges passing through a layer keep edge spacing
+        void SetNodeSpacing(float spacing) { node_spacing_ = spacing; }
+        void SetEdgeSpacing(float spacing) { edge_spacing_ = spacing; }
+        // alternating down and up barycenter passes, the order with the fewest crossings is kept
+        void SetSweeps(int sweeps) { sweeps_ = sweeps; }
+        // workers for large layers and the alignment passes, 0 uses every hardware thread
+        void SetThreads(int threads) { threads_ = threads; }
+
+        // of the last Apply()
+        uint32_t GetLayerCount() const { return layers_; }
+        uint32_t GetDummyCount() const { return dummies_; }
+        uint32_t GetReversedCount() const { return reversed_; }
+        size_t GetCrossingCount() const { return crossings_; }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // Fruchterman-Reingold spring embedder stepped from frame to frame, repulsion is approximated with a
+    // Barnes-Hut quadtree so an iteration is n log n, the bodies are split between workers
+    // nodes move straight in their area_node_ while it runs and the whole run becomes one undo step when it
+    // ends, selected, pinned and dragged nodes stay where they are and still push and pull the others
+    struct ImGuiNodesForceLayout
+    {
+    private:
+        // four children are allocated together, first_ is the top left one
+        struct Cell
+        {
+            ImVec2 center_;
+            float half_;
+            float mass_;
+            ImVec2 sum_; // of the positions, the center of mass once built
+            uint32_t first_;
+            uint32_t body_;
+        };
+
+        float ideal_length_ = 250.0f;
+        float theta_ = 0.8f;
+        float gravity_ = 0.01f;
+        float cooling_ = 0.97f;
+        int max_iterations_ = 500;
+        int threads_ = 0;
+
+        bool running_ = false;
+        int iteration_ = 0;
+        float temperature_ = 0.0f;
+        size_t cursor_ = 0; // next body of the iteration in progress
+
+        std::vector<ImGuiNodesNode *> nodes_;
+        std::vector<uint32_t> ids_; // of nodes_, read when they may be freed already
+        uint64_t graph_ = 0;        // hash of the ids and inputs the adjacency was built from
+        uint32_t generation_ = 0;   // of the graph nodes_ came from
+        std::unordered_map<const ImGuiNodesNode *, uint32_t> index_;
+        std::vector<uint32_t> offsets_;
+        std::vector<uint32_t> neighbours_;
+        std::unordered_set<uint32_t> pinned_; // by node id
+
+        std::vector<ImVec2> positions_; // centers
+        std::vector<ImVec2> forces_;
+        std::vector<ImVec2> moved_; // by the layout since Start()
+        std::vector<uint8_t> fixed_;
+        std::vector<Cell> cells_;
+
+        static uint64_t HashGraph(const std::vector<ImGuiNodesNode *> &nodes);
+
+        void Sync(const ImGuiNodes &nodes);
+        void Gather(const ImGuiNodes &nodes);
+        void BuildTree();
+        void Push(size_t first, size_t last);
+        void Advance();
+        void Commit(ImGuiNodes &nodes);
+
+    public:
+        // starts from the current positions, nodes stacked on one spot are spread out
+        void Start(ImGuiNodes &nodes);
+        // runs iterations for about the given time and moves the nodes, false once it is done
+        // the graph may change in between, an iteration that does not fit is resumed in the next call
+        bool Step(ImGuiNodes &nodes, double milliseconds);
+        // keeps the positions reached, the moves so far become one undo step
+        void Stop(ImGuiNodes &nodes);
+
+        bool IsRunning() const { return running_; }
+        int GetIteration() const { return iteration_; }
+        float GetTemperature() const { return temperature_; }
+
+        void Pin(const ImGuiNodesNode *node, bool pinned = true);
+        bool IsPinned(const ImGuiNodesNode *node) const { return pinned_.count(node->id_) != 0; }
+
+        // rest length of a link in world units
+        void SetIdealLength(float length) { ideal_length_ = length; }
+        // cells smaller than theta times their distance count as one body, 0 is exact and quadratic
+        void SetTheta(float theta) { theta_ = theta; }
+        // pull towards the center of mass, keeps unconnected parts together
+        void SetGravity(float gravity) { gravity_ = gravity; }
+        // the largest move of an iteration shrinks by this factor, the run ends once it is below a unit
+        void SetCooling(float cooling) { cooling_ = cooling; }
+        void SetMaxIterations(int iterations) { max_iterations_ = iterations; }
+        // workers for the bodies, 0 uses every hardware thread
+        void SetThreads(int threads) { threads_ = threads; }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+}
+
+#if defined(IMGUI_NODES_HEADER_ONLY)
+#include "ImGuiNodesLayout.cc"
+#endif
+
+#endif // !IMGUI_NODES_LAYOUT_H
@@ -0,0 +1,708 @@
+#include "ImGuiNodesPager.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace ImGui
+{
+    template <typename T>
+    static inline const T *GetPageSection(const ImGuiNodesMappedFile &file, uint64_t offset, uint64_t count)
+    {
+        if (offset % alignof(T) != 0 || offset > file.GetSize())
+            return nullptr;
+
+        if (count > (file.GetSize() - offset) / sizeof(T))
+            return nullptr;
+
+        return reinterpret_cast<const T *>(file.GetData() + offset);
+    }
+
+    // the file offset is tracked by hand, ftell() is 32 bit on some targets and page files are not
+    static inline bool WritePageBytes(FILE *file, uint64_t &offset, const void *data, size_t size)
+    {
+        if (0 == size)
+            return true;
+
+        offset += size;
+        return 1 == fwrite(data, size, 1, file);
+    }
+
+    static inline bool AlignPageFile(FILE *file, uint64_t &offset)
+    {
+        static const unsigned char padding[ImGuiNodesSnapshotAlignment] = {};
+
+        const uint64_t aligned = (offset + ImGuiNodesSnapshotAlignment - 1) & ~(ImGuiNodesSnapshotAlignment - 1);
+
+        return WritePageBytes(file, offset, padding, static_cast<size_t>(aligned - offset));
+    }
+
+    // clamped well inside int32_t, so a tile plus or minus one never wraps
+    static inline int32_t GetPageCoord(float value, float tile_size)
+    {
+        const float coord = floorf(value / tile_size);
+
+        if (!(coord > -1073741824.0f))
+            return -1073741824;
+
+        if (coord > 1073741823.0f)
+            return 1073741823;
+
+        return static_cast<int32_t>(coord);
+    }
+
+    static inline uint64_t GetPageLinkKey(uint32_t node, uint32_t slot)
+    {
+        return (uint64_t(node) << 32) | slot;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    bool ImGuiNodesPager::Build(const char *path, const ImGuiNodesSnapshotSections &sections, float tile_size)
+    {
+        if (!(tile_size > 0.0f) || !sections.Validate())
+            return false;
+
+        const uint64_t node_count = sections.node_count_;
+
+        // ids have to be unique, the pager finds both ends of an edge by them
+        std::vector<uint32_t> ids(node_count);
+        uint32_t max_id = 0;
+
+        for (uint64_t node_idx = 0; node_idx < node_count; ++node_idx)
+        {
+            ids[node_idx] = sections.nodes_[node_idx].id_;
+            max_id = ImMax(max_id, ids[node_idx]);
+        }
+
+        for (uint64_t node_idx = 0; node_idx < node_count; ++node_idx)
+        {
+            if (0 != ids[node_idx])
+                continue;
+
+            if (UINT32_MAX == max_id)
+                return false;
+
+            ids[node_idx] = ++max_id;
+        }
+
+        {
+            std::vector<uint32_t> sorted(ids);
+            std::sort(sorted.begin(), sorted.end());
+
+            if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+                return false;
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::pair<uint64_t, uint32_t>> order(node_count);
+
+        for (uint64_t node_idx = 0; node_idx < node_count; ++node_idx)
+        {
+            const ImVec2 pos = sections.nodes_[node_idx].pos_;
+            order[node_idx] = {ImGuiNodesPageTile::GetKey(GetPageCoord(pos.x, tile_size), GetPageCoord(pos.y, tile_size)), static_cast<uint32_t>(node_idx)};
+        }
+
+        std::sort(order.begin(), order.end());
+
+        std::vector<ImGuiNodesPageTile> tiles;
+        std::vector<uint32_t> node_tiles(node_count);
+
+        for (uint64_t order_idx = 0; order_idx < node_count; ++order_idx)
+        {
+            if (tiles.empty() || tiles.back().GetKey() != order[order_idx].first)
+            {
+                const ImVec2 pos = sections.nodes_[order[order_idx].second].pos_;
+
+                ImGuiNodesPageTile &tile = tiles.emplace_back();
+                tile = {};
+                tile.x_ = GetPageCoord(pos.x, tile_size);
+                tile.y_ = GetPageCoord(pos.y, tile_size);
+            }
+
+            tiles.back().node_count_++;
+            node_tiles[order[order_idx].second] = static_cast<uint32_t>(tiles.size() - 1);
+        }
+
+        // (tile, edge) for the tile of the input node and the one of the output node
+        std::vector<std::pair<uint32_t, uint32_t>> placements;
+        placements.reserve(sections.edge_count_ + sections.edge_count_ / 8);
+
+        for (uint64_t edge_idx = 0; edge_idx < sections.edge_count_; ++edge_idx)
+        {
+            const ImGuiNodesEdge &edge = sections.edges_[edge_idx];
+            const uint32_t input_tile = node_tiles[edge.input_node_];
+            const uint32_t output_tile = node_tiles[edge.output_node_];
+
+            placements.push_back({input_tile, static_cast<uint32_t>(edge_idx)});
+
+            if (output_tile != input_tile)
+                placements.push_back({output_tile, static_cast<uint32_t>(edge_idx)});
+        }
+
+        std::sort(placements.begin(), placements.end());
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        ImGuiNodesPageHeader header{};
+        memcpy(header.magic_, ImGuiNodesPageMagic, sizeof(header.magic_));
+        header.version_ = ImGuiNodesPageVersion;
+        header.byte_order_ = ImGuiNodesSnapshotByteOrder;
+        header.scroll_ = sections.scroll_;
+        header.scale_ = sections.scale_;
+        header.tile_size_ = tile_size;
+        header.max_id_ = max_id;
+        header.desc_count_ = sections.desc_count_;
+        header.connector_count_ = sections.connector_count_;
+        header.tile_count_ = tiles.size();
+        header.node_count_ = node_count;
+
+        FILE *file = fopen(path, "wb");
+        if (nullptr == file)
+            return false;
+
+        uint64_t offset = 0;
+        bool succeed = WritePageBytes(file, offset, &header, sizeof(header));
+
+        succeed = succeed && AlignPageFile(file, offset);
+        header.desc_offset_ = offset;
+        succeed = succeed && WritePageBytes(file, offset, sections.descs_, sections.desc_count_ * sizeof(ImGuiNodesSnapshotDesc));
+
+        succeed = succeed && AlignPageFile(file, offset);
+        header.connector_offset_ = offset;
+        succeed = succeed && WritePageBytes(file, offset, sections.connectors_, sections.connector_count_ * sizeof(ImGuiNodesConnectionDesc));
+
+        std::vector<ImGuiNodesSnapshotNode> tile_nodes;
+        std::vector<ImGuiNodesEdge> tile_edges;
+        std::vector<char> tile_names;
+
+        size_t order_idx = 0;
+        size_t placement_idx = 0;
+
+        for (uint32_t tile_idx = 0; succeed && tile_idx < tiles.size(); ++tile_idx)
+        {
+            ImGuiNodesPageTile &tile = tiles[tile_idx];
+
+            tile_nodes.clear();
+            tile_edges.clear();
+            tile_names.clear();
+
+            for (uint32_t node_idx = 0; node_idx < tile.node_count_; ++node_idx, ++order_idx)
+            {
+                const uint32_t index = order[order_idx].second;
+
+                ImGuiNodesSnapshotNode record = sections.nodes_[index];
+                record.id_ = ids[index];
+
+                if (record.name_)
+                {
+                    const char *name = sections.names_ + record.name_ - 1;
+
+                    record.name_ = static_cast<uint32_t>(tile_names.size() + 1);
+                    tile_names.insert(tile_names.end(), name, name + strlen(name) + 1);
+                }
+
+                tile_nodes.push_back(record);
+            }
+
+            for (; placement_idx < placements.size() && placements[placement_idx].first == tile_idx; ++placement_idx)
+            {
+                const ImGuiNodesEdge &edge = sections.edges_[placements[placement_idx].second];
+                tile_edges.push_back({ids[edge.output_node_], edge.output_slot_, ids[edge.input_node_], edge.input_slot_});
+            }
+
+            tile.edge_count_ = static_cast<uint32_t>(tile_edges.size());
+            tile.names_size_ = tile_names.size();
+
+            succeed = succeed && AlignPageFile(file, offset);
+            tile.node_offset_ = offset;
+            succeed = succeed && WritePageBytes(file, offset, tile_nodes.data(), tile_nodes.size() * sizeof(ImGuiNodesSnapshotNode));
+
+            succeed = succeed && AlignPageFile(file, offset);
+            tile.edge_offset_ = offset;
+            succeed = succeed && WritePageBytes(file, offset, tile_edges.data(), tile_edges.size() * sizeof(ImGuiNodesEdge));
+
+            tile.names_offset_ = offset;
+            succeed = succeed && WritePageBytes(file, offset, tile_names.data(), tile_names.size());
+        }
+
+        succeed = succeed && AlignPageFile(file, offset);
+        header.tile_offset_ = offset;
+        succeed = succeed && WritePageBytes(file, offset, tiles.data(), tiles.size() * sizeof(ImGuiNodesPageTile));
+
+        // the offsets are only known now
+        succeed = succeed && 0 == fseek(file, 0, SEEK_SET);
+        succeed = succeed && 1 == fwrite(&header, sizeof(header), 1, file);
+
+        return 0 == fclose(file) && succeed;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    bool ImGuiNodesPager::Open(ImGuiNodes &nodes, const char *path)
+    {
+        Close();
+
+        if (!file_.Open(path))
+            return false;
+
+        const ImGuiNodesPageHeader *header = GetPageSection<ImGuiNodesPageHeader>(file_, 0, 1);
+
+        bool succeed = nullptr != header;
+        succeed = succeed && 0 == memcmp(header->magic_, ImGuiNodesPageMagic, sizeof(header->magic_));
+        succeed = succeed && header->version_ == ImGuiNodesPageVersion && header->byte_order_ == ImGuiNodesSnapshotByteOrder;
+        succeed = succeed && header->tile_size_ > 0.0f;
+
+        // nodes and edges are checked tile by tile when they load, the descs are needed right away
+        ImGuiNodesSnapshotSections sections;
+
+        if (succeed)
+        {
+            sections.descs_ = GetPageSection<ImGuiNodesSnapshotDesc>(file_, header->desc_offset_, header->desc_count_);
+            sections.connectors_ = GetPageSection<ImGuiNodesConnectionDesc>(file_, header->connector_offset_, header->connector_count_);
+            sections.desc_count_ = header->desc_count_;
+            sections.connector_count_ = header->connector_count_;
+
+            tiles_ = GetPageSection<ImGuiNodesPageTile>(file_, header->tile_offset_, header->tile_count_);
+
+            succeed = sections.descs_ && sections.connectors_ && tiles_ && sections.Validate();
+        }
+
+        for (uint64_t tile_idx = 1; succeed && tile_idx < header->tile_count_; ++tile_idx)
+            succeed = tiles_[tile_idx - 1].GetKey() < tiles_[tile_idx].GetKey();
+
+        if (!succeed)
+        {
+            tiles_ = nullptr;
+            file_.Close();
+            return false;
+        }
+
+        header_ = header;
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        for (ImGuiNodesNode *node : nodes.nodes_)
+            delete node;
+
+        // also detaches a pager already paging this editor
+        nodes.Clear();
+        nodes.name_pool_.clear();
+
+        nodes.state_ = ImGuiNodesState_Default;
+        nodes.connection_ = ImVec4();
+
+        nodes.RegisterSnapshotDescs(sections, descs_);
+        nodes.next_node_id_ = ImMax(nodes.next_node_id_, header_->max_id_);
+
+        nodes.scroll_ = header_->scroll_;
+        nodes.scale_ = ImClamp(header_->scale_, 0.3f, 3.0f);
+
+        nodes.pager_ = this;
+        nodes_ = &nodes;
+
+        return true;
+    }
+
+    void ImGuiNodesPager::Close()
+    {
+        if (nodes_)
+        {
+            evicting_.clear();
+
+            for (const auto &resident : residents_)
+                evicting_.push_back(resident.first);
+
+            nodes_->state_ = ImGuiNodesState_Default;
+            nodes_->connection_ = ImVec4();
+
+            Evict(evicting_);
+
+            nodes_->pager_ = nullptr;
+            nodes_ = nullptr;
+        }
+
+        Detach();
+
+        file_.Close();
+        header_ = nullptr;
+        tiles_ = nullptr;
+        descs_.clear();
+
+        loads_ = 0;
+        evictions_ = 0;
+    }
+
+    void ImGuiNodesPager::Detach()
+    {
+        nodes_ = nullptr;
+
+        residents_.clear();
+        by_id_.clear();
+        overrides_.clear();
+        links_.clear();
+        deleted_.clear();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    const ImGuiNodesPageTile *ImGuiNodesPager::FindTile(int32_t x, int32_t y) const
+    {
+        const uint64_t key = ImGuiNodesPageTile::GetKey(x, y);
+
+        const ImGuiNodesPageTile *end = tiles_ + header_->tile_count_;
+        const ImGuiNodesPageTile *tile = std::lower_bound(tiles_, end, key, [](const ImGuiNodesPageTile &tile, uint64_t key)
+                                                          { return tile.GetKey() < key; });
+
+        return tile != end && tile->GetKey() == key ? tile : nullptr;
+    }
+
+    bool ImGuiNodesPager::ValidateTile(const ImGuiNodesPageTile &tile) const
+    {
+        ImGuiNodesSnapshotSections sections;
+        sections.descs_ = GetPageSection<ImGuiNodesSnapshotDesc>(file_, header_->desc_offset_, header_->desc_count_);
+        sections.connectors_ = GetPageSection<ImGuiNodesConnectionDesc>(file_, header_->connector_offset_, header_->connector_count_);
+        sections.nodes_ = GetPageSection<ImGuiNodesSnapshotNode>(file_, tile.node_offset_, tile.node_count_);
+        sections.names_ = GetPageSection<char>(file_, tile.names_offset_, tile.names_size_);
+
+        // edges name nodes by id, ids missing from the file are skipped when connecting
+        if (nullptr == sections.nodes_ || nullptr == sections.names_ || nullptr == GetPageSection<ImGuiNodesEdge>(file_, tile.edge_offset_, tile.edge_count_))
+            return false;
+
+        sections.desc_count_ = header_->desc_count_;
+        sections.connector_count_ = header_->connector_count_;
+        sections.node_count_ = tile.node_count_;
+        sections.names_size_ = tile.names_size_;
+
+        return sections.Validate();
+    }
+
+    void ImGuiNodesPager::Connect(ImGuiNodesNode *input_node, uint32_t input_slot, ImGuiNodesNode *output_node, uint32_t output_slot)
+    {
+        // slots are checked against the live desc like in BuildBatch()
+        if (input_slot >= input_node->inputs_.size())
+            return;
+
+        if (output_node && output_slot >= output_node->outputs_.size())
+            return;
+
+        const ImGuiNodesInput &input = input_node->inputs_[input_slot];
+        const ImGuiNodesOutput *output = output_node ? &output_node->outputs_[output_slot] : nullptr;
+
+        if (input.target_ != output_node || input.output_ != output)
+            nodes_->SetInput(input_node, input_slot, output_node, output_slot);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void ImGuiNodesPager::Update()
+    {
+        IMGUI_NODES_TRACE_SCOPE("Paging");
+
+        const ImGuiNodes &nodes = *nodes_;
+        const float tile_size = header_->tile_size_;
+
+        ++frame_;
+
+        const ImVec2 view_min = (ImVec2(0.0f, 0.0f) - nodes.scroll_) / nodes.scale_;
+        const ImVec2 view_max = (nodes.size_ - nodes.scroll_) / nodes.scale_;
+        const float margin = margin_ / nodes.scale_;
+
+        // nodes reach right and down from the corner that picks their tile, so one more tile up and left
+        const int32_t visible_x0 = GetPageCoord(view_min.x, tile_size) - 1;
+        const int32_t visible_y0 = GetPageCoord(view_min.y, tile_size) - 1;
+        const int32_t visible_x1 = GetPageCoord(view_max.x, tile_size);
+        const int32_t visible_y1 = GetPageCoord(view_max.y, tile_size);
+
+        const int32_t x0 = GetPageCoord(view_min.x - margin, tile_size) - 1;
+        const int32_t y0 = GetPageCoord(view_min.y - margin, tile_size) - 1;
+        const int32_t x1 = GetPageCoord(view_max.x + margin, tile_size);
+        const int32_t y1 = GetPageCoord(view_max.y + margin, tile_size);
+
+        loading_.clear();
+        int prefetched = 0;
+
+        for (int32_t y = y0; y <= y1; ++y)
+        {
+            for (int32_t x = x0; x <= x1; ++x)
+            {
+                const ImGuiNodesPageTile *tile = FindTile(x, y);
+                if (nullptr == tile)
+                    continue;
+
+                auto resident = residents_.find(tile->GetKey());
+                if (resident != residents_.end())
+                {
+                    resident->second.last_seen_ = frame_;
+                    continue;
+                }
+
+                const bool visible = x >= visible_x0 && x <= visible_x1 && y >= visible_y0 && y <= visible_y1;
+
+                if (visible || prefetched++ < prefetch_per_frame_)
+                    loading_.push_back(static_cast<uint64_t>(tile - tiles_));
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        // a drag or a pending connection holds nodes across frames, eviction waits for it to finish
+        if (nodes.state_ == ImGuiNodesState_Default && residents_.size() + loading_.size() > tile_budget_)
+        {
+            evicting_.clear();
+
+            for (const auto &resident : residents_)
+                if (resident.second.last_seen_ != frame_)
+                    evicting_.push_back(resident.first);
+
+            const size_t excess = ImMin(residents_.size() + loading_.size() - tile_budget_, evicting_.size());
+
+            std::partial_sort(evicting_.begin(), evicting_.begin() + excess, evicting_.end(), [this](uint64_t lhs, uint64_t rhs)
+                              { return residents_.at(lhs).last_seen_ < residents_.at(rhs).last_seen_; });
+
+            evicting_.resize(excess);
+
+            if (!evicting_.empty())
+                Evict(evicting_);
+        }
+
+        if (!loading_.empty())
+            Load(loading_);
+    }
+
+    void ImGuiNodesPager::Load(const std::vector<uint64_t> &tiles)
+    {
+        ImGuiNodes &nodes = *nodes_;
+
+        // one batch for all tiles of the frame, text is measured once per desc
+        ImGuiNodesBatch batch;
+        batch.top_left_ = true;
+
+        for (uint64_t tile_idx : tiles)
+        {
+            const ImGuiNodesPageTile &tile = tiles_[tile_idx];
+
+            residents_[tile.GetKey()] = {tile_idx, frame_};
+            ++loads_;
+
+            // a broken tile stays resident and empty instead of being retried every frame
+            if (!ValidateTile(tile))
+                continue;
+
+            const ImGuiNodesSnapshotNode *records = reinterpret_cast<const ImGuiNodesSnapshotNode *>(file_.GetData() + tile.node_offset_);
+            const char *names = reinterpret_cast<const char *>(file_.GetData() + tile.names_offset_);
+
+            for (uint32_t node_idx = 0; node_idx < tile.node_count_; ++node_idx)
+            {
+                const ImGuiNodesSnapshotNode &record = records[node_idx];
+
+                if (deleted_.count(record.id_) || by_id_.count(record.id_))
+                    continue;
+
+                ImVec2 pos = record.pos_;
+                ImGuiNodesNodeState state = record.state_;
+
+                auto override = overrides_.find(record.id_);
+                if (override != overrides_.end())
+                {
+                    pos = override->second.pos_;
+                    state = override->second.state_;
+                }
+
+                // names point into the mapped file, it outlives every paged node
+                const uint32_t index = batch.AddNode(descs_[record.desc_], pos, state & ImGuiNodesSnapshotNodeStateMask, record.name_ ? names + record.name_ - 1 : nullptr);
+                batch.nodes_[index].id_ = record.id_;
+            }
+        }
+
+        const size_t first_node = nodes.nodes_.size();
+        nodes.BuildBatch(batch);
+
+        for (size_t node_idx = first_node; node_idx < nodes.nodes_.size(); ++node_idx)
+            by_id_[nodes.nodes_[node_idx]->id_] = nodes.nodes_[node_idx];
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        for (uint64_t tile_idx : tiles)
+        {
+            const ImGuiNodesPageTile &tile = tiles_[tile_idx];
+
+            if (!GetPageSection<ImGuiNodesEdge>(file_, tile.edge_offset_, tile.edge_count_))
+                continue;
+
+            const ImGuiNodesEdge *edges = reinterpret_cast<const ImGuiNodesEdge *>(file_.GetData() + tile.edge_offset_);
+
+            for (uint32_t edge_idx = 0; edge_idx < tile.edge_count_; ++edge_idx)
+            {
+                const ImGuiNodesEdge &edge = edges[edge_idx];
+
+                // edited inputs are connected from the links below
+                if (links_.count(GetPageLinkKey(edge.input_node_, edge.input_slot_)))
+                    continue;
+
+                auto input_node = by_id_.find(edge.input_node_);
+                auto output_node = by_id_.find(edge.output_node_);
+
+                if (input_node != by_id_.end() && output_node != by_id_.end())
+                    Connect(input_node->second, edge.input_slot_, output_node->second, edge.output_slot_);
+            }
+        }
+
+        if (links_.empty())
+            return;
+
+        // nodes created in the editor are never paged out and have ids above the file
+        std::unordered_map<uint32_t, ImGuiNodesNode *> created;
+
+        for (ImGuiNodesNode *node : nodes.nodes_)
+            if (node->id_ > header_->max_id_)
+                created.emplace(node->id_, node);
+
+        auto find = [&](uint32_t id) -> ImGuiNodesNode *
+        {
+            const std::unordered_map<uint32_t, ImGuiNodesNode *> &index = id > header_->max_id_ ? created : by_id_;
+
+            auto node = index.find(id);
+            return node != index.end() ? node->second : nullptr;
+        };
+
+        for (const auto &link : links_)
+        {
+            ImGuiNodesNode *input_node = find(static_cast<uint32_t>(link.first >> 32));
+            if (nullptr == input_node)
+                continue;
+
+            ImGuiNodesNode *output_node = link.second.output_node_ ? find(link.second.output_node_) : nullptr;
+
+            // the output is paged out, its tile connects it once it is back
+            if (link.second.output_node_ && nullptr == output_node)
+                continue;
+
+            Connect(input_node, static_cast<uint32_t>(link.first), output_node, link.second.output_slot_);
+        }
+    }
+
+    void ImGuiNodesPager::Evict(const std::vector<uint64_t> &tiles)
+    {
+        ImGuiNodes &nodes = *nodes_;
+
+        const std::unordered_set<ImGuiNodesNode *> graph(nodes.nodes_.begin(), nodes.nodes_.end());
+        std::unordered_set<ImGuiNodesNode *> evicted;
+
+        for (uint64_t key : tiles)
+        {
+            auto resident = residents_.find(key);
+            if (resident == residents_.end())
+                continue;
+
+            const ImGuiNodesPageTile &tile = tiles_[resident->second.tile_];
+
+            residents_.erase(resident);
+            ++evictions_;
+
+            if (!GetPageSection<ImGuiNodesSnapshotNode>(file_, tile.node_offset_, tile.node_count_))
+                continue;
+
+            const ImGuiNodesSnapshotNode *records = reinterpret_cast<const ImGuiNodesSnapshotNode *>(file_.GetData() + tile.node_offset_);
+
+            for (uint32_t node_idx = 0; node_idx < tile.node_count_; ++node_idx)
+            {
+                const ImGuiNodesSnapshotNode &record = records[node_idx];
+
+                auto loaded = by_id_.find(record.id_);
+                if (loaded == by_id_.end())
+                    continue;
+
+                ImGuiNodesNode *node = loaded->second;
+                by_id_.erase(loaded);
+
+                // gone from the graph means deleted, the pointer may be freed so only a live one is looked at
+                if (!graph.count(node) || node->id_ != record.id_)
+                {
+                    deleted_.insert(record.id_);
+                    continue;
+                }
+
+                const ImVec2 pos = node->area_node_.Min;
+                const ImGuiNodesNodeState state = node->state_ & ImGuiNodesSnapshotNodeStateMask;
+
+                if (pos.x != record.pos_.x || pos.y != record.pos_.y || state != (record.state_ & ImGuiNodesSnapshotNodeStateMask))
+                    overrides_[record.id_] = {pos, state};
+                else
+                    overrides_.erase(record.id_);
+
+                evicted.insert(node);
+            }
+        }
+
+        if (evicted.empty())
+            return;
+
+        forgetting_.assign(evicted.begin(), evicted.end());
+        nodes.journal_.Forget(forgetting_.data(), forgetting_.size());
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        // no input is left pointing at an evicted node and evicted inputs hand back their output connections
+        for (ImGuiNodesNode *node : nodes.nodes_)
+        {
+            const bool node_evicted = evicted.count(node) > 0;
+
+            for (size_t input_idx = 0; input_idx < node->inputs_.size(); ++input_idx)
+            {
+                ImGuiNodesNode *target = node->inputs_[input_idx].target_;
+
+                if (target && (node_evicted || evicted.count(target)))
+                    nodes.SetInput(node, input_idx, NULL, 0);
+            }
+        }
+
+        nodes.nodes_.erase(std::remove_if(nodes.nodes_.begin(), nodes.nodes_.end(), [&](ImGuiNodesNode *node)
+                                          { return evicted.count(node) > 0; }),
+                           nodes.nodes_.end());
+
+        nodes.element_node_ = NULL;
+        nodes.element_input_ = NULL;
+        nodes.element_output_ = NULL;
+
+        if (evicted.count(nodes.processing_node_))
+            nodes.processing_node_ = NULL;
+
+        for (ImGuiNodesNode *node : evicted)
+            delete node;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void ImGuiNodesPager::OnLink(const ImGuiNodesNode *input_node, size_t input_slot, const ImGuiNodesNode *output_node, size_t output_slot)
+    {
+        Link &link = links_[GetPageLinkKey(input_node->id_, static_cast<uint32_t>(input_slot))];
+
+        link.output_node_ = output_node ? output_node->id_ : 0;
+        link.output_slot_ = output_node ? static_cast<uint32_t>(output_slot) : 0;
+    }
+
+    void ImGuiNodesPager::OnRemove(const ImGuiNodesNode *node)
+    {
+        auto loaded = by_id_.find(node->id_);
+
+        if (loaded != by_id_.end() && loaded->second == node)
+        {
+            by_id_.erase(loaded);
+            deleted_.insert(node->id_);
+        }
+    }
+
+    void ImGuiNodesPager::OnRestore(ImGuiNodesNode *node)
+    {
+        // undone deletion, its tile skips it until the node is evicted with the tile again
+        if (node->id_ > header_->max_id_ || 0 == deleted_.erase(node->id_))
+            return;
+
+        by_id_[node->id_] = node;
+    }
+}
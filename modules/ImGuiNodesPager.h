@@ -0,0 +1,177 @@
+#ifndef IMGUI_NODES_PAGER_H // !IMGUI_NODES_PAGER_H
+#define IMGUI_NODES_PAGER_H
+
+#include "ImGuiNodes.h"
+#include "ImGuiNodesSnapshot.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ImGui
+{
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // ImGuiNodesPager::Build() file layout, host byte order, every section starts on ImGuiNodesSnapshotAlignment:
+    // header, desc table, connector table, then per tile its nodes, edges and names, then the tile table
+    // nodes belong to the tile holding their top left corner, an edge is stored with its input node and again
+    // with its output node when that one lives in another tile, so loading either end finds it
+    constexpr char ImGuiNodesPageMagic[8] = {'I', 'G', 'N', 'P', 'A', 'G', 'E', '\0'};
+    constexpr uint32_t ImGuiNodesPageVersion = 1;
+
+    struct ImGuiNodesPageHeader
+    {
+        char magic_[8];
+        uint32_t version_;
+        uint32_t byte_order_;
+
+        ImVec2 scroll_;
+        float scale_;
+        float tile_size_;
+
+        uint32_t max_id_;
+        uint32_t reserved_;
+
+        uint64_t desc_count_;
+        uint64_t connector_count_;
+        uint64_t tile_count_;
+        uint64_t node_count_;
+
+        uint64_t desc_offset_;
+        uint64_t connector_offset_;
+        uint64_t tile_offset_;
+    };
+
+    // sorted by GetKey(), node names are offsets into the tile names plus one and edges name nodes by id
+    struct ImGuiNodesPageTile
+    {
+        int32_t x_;
+        int32_t y_;
+        uint32_t node_count_;
+        uint32_t edge_count_;
+
+        uint64_t node_offset_;
+        uint64_t edge_offset_;
+        uint64_t names_offset_;
+        uint64_t names_size_;
+
+        static uint64_t GetKey(int32_t x, int32_t y) { return (uint64_t(uint32_t(y)) << 32) | uint32_t(x); }
+        uint64_t GetKey() const { return GetKey(x_, y_); }
+    };
+
+    static_assert(sizeof(ImGuiNodesPageTile) == 48);
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // keeps only the tiles around the view of an editor as nodes, the rest of the graph stays in a mapped page file
+    // tiles are loaded by ImGuiNodes::Update() and evicted least recently seen first once over the budget
+    // edits of paged nodes outlive their tile in memory, they are not written back to the page file
+    // the undo history forgets evicted nodes like RemoveNode(), listeners and savers only see the loaded part
+    struct ImGuiNodesPager
+    {
+    private:
+        friend struct ImGuiNodes;
+
+        struct Resident
+        {
+            uint64_t tile_;      // index into the tile table
+            uint64_t last_seen_; // frame
+        };
+
+        // what the page file holds no longer applies to these nodes
+        struct Override
+        {
+            ImVec2 pos_;
+            ImGuiNodesNodeState state_;
+        };
+
+        struct Link
+        {
+            uint32_t output_node_; // zero for disconnected
+            uint32_t output_slot_;
+        };
+
+        ImGuiNodes *nodes_ = nullptr;
+        ImGuiNodesMappedFile file_;
+
+        const ImGuiNodesPageHeader *header_ = nullptr;
+        const ImGuiNodesPageTile *tiles_ = nullptr;
+        std::vector<ImGuiNodesNodeDesc *> descs_;
+
+        float margin_ = 512.0f;
+        size_t tile_budget_ = 256;
+        int prefetch_per_frame_ = 4;
+
+        uint64_t frame_ = 0;
+        std::unordered_map<uint64_t, Resident> residents_;  // by tile key
+        std::unordered_map<uint32_t, ImGuiNodesNode *> by_id_; // loaded paged nodes
+
+        std::unordered_map<uint32_t, Override> overrides_;
+        std::unordered_map<uint64_t, Link> links_; // by input node id and slot
+        std::unordered_set<uint32_t> deleted_;
+
+        size_t loads_ = 0;
+        size_t evictions_ = 0;
+
+        // scratch kept between frames
+        std::vector<uint64_t> wanted_;
+        std::vector<uint64_t> loading_;
+        std::vector<uint64_t> evicting_;
+        std::vector<ImGuiNodesNode *> forgetting_;
+
+        const ImGuiNodesPageTile *FindTile(int32_t x, int32_t y) const;
+        bool ValidateTile(const ImGuiNodesPageTile &tile) const;
+
+        void Update();
+        void Load(const std::vector<uint64_t> &tiles);
+        void Evict(const std::vector<uint64_t> &tiles);
+        void Connect(ImGuiNodesNode *input_node, uint32_t input_slot, ImGuiNodesNode *output_node, uint32_t output_slot);
+
+        // from the editor
+        void OnLink(const ImGuiNodesNode *input_node, size_t input_slot, const ImGuiNodesNode *output_node, size_t output_slot);
+        void OnRemove(const ImGuiNodesNode *node);
+        void OnRestore(ImGuiNodesNode *node);
+        void Detach();
+
+    public:
+        // replaces the graph of the editor with the page file, tiles show up from the next Update()
+        bool Open(ImGuiNodes &nodes, const char *path);
+        // removes the loaded tiles from the editor, edits kept for paged nodes are dropped
+        void Close();
+
+        bool IsOpen() const { return header_ != nullptr; }
+
+        // screen pixels loaded around the view, divided by the scale so zooming out prefetches more of the world
+        void SetMargin(float pixels) { margin_ = pixels; }
+        // tiles kept loaded, tiles inside the view and margin are never evicted even over the budget
+        void SetTileBudget(size_t tiles) { tile_budget_ = tiles; }
+        // tiles of the margin loaded per frame, tiles inside the view always load right away
+        void SetPrefetchPerFrame(int tiles) { prefetch_per_frame_ = tiles; }
+
+        float GetTileSize() const { return header_ ? header_->tile_size_ : 0.0f; }
+        uint64_t GetTileCount() const { return header_ ? header_->tile_count_ : 0; }
+        uint64_t GetNodeCount() const { return header_ ? header_->node_count_ : 0; }
+        size_t GetResidentTiles() const { return residents_.size(); }
+        size_t GetResidentNodes() const { return by_id_.size(); }
+        size_t GetLoads() const { return loads_; }
+        size_t GetEvictions() const { return evictions_; }
+
+        // tiles the nodes of a snapshot by world position, zero ids are replaced by fresh ones
+        // holds index arrays for every node and edge while writing, far less than the nodes themselves
+        static bool Build(const char *path, const ImGuiNodesSnapshotSections &sections, float tile_size = 2048.0f);
+
+        ImGuiNodesPager() = default;
+        ImGuiNodesPager(const ImGuiNodesPager &) = delete;
+        ImGuiNodesPager &operator=(const ImGuiNodesPager &) = delete;
+        ~ImGuiNodesPager() { Close(); }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+}
+
+#if defined(IMGUI_NODES_HEADER_ONLY)
+#include "ImGuiNodesPager.cc"
+#endif
+
+#endif // !IMGUI_NODES_PAGER_H
@@ -0,0 +1,213 @@
+#include "ImGuiNodesRecorder.h"
+
+#include <stdio.h>
+
+namespace ImGui
+{
+    // file layout, host byte order:
+    // magic, version, display size, tag, frame count, then per frame
+    // delta time, mouse pos, wheel, wheel h, buttons, modifiers, key count, keys
+    constexpr char ImGuiNodesRecordMagic[4] = {'I', 'G', 'N', 'R'};
+    constexpr uint32_t ImGuiNodesRecordVersion = 1;
+
+    constexpr int ImGuiNodesRecordKeys = ImGuiKey_GamepadStart - ImGuiKey_Tab;
+
+    template <typename T>
+    static inline bool WriteRecordValue(FILE *file, const T &value)
+    {
+        return 1 == fwrite(&value, sizeof(T), 1, file);
+    }
+
+    template <typename T>
+    static inline bool ReadRecordValue(FILE *file, T &value)
+    {
+        return 1 == fread(&value, sizeof(T), 1, file);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void ImGuiNodesRecorder::Record()
+    {
+        const ImGuiIO &io = ImGui::GetIO();
+
+        if (frames_.empty())
+            display_size_ = io.DisplaySize;
+
+        if (keys_down_.empty())
+            keys_down_.resize(ImGuiNodesRecordKeys, 0);
+
+        ImGuiNodesInputFrame &frame = frames_.emplace_back();
+        frame.delta_time_ = io.DeltaTime;
+        frame.mouse_pos_ = io.MousePos;
+        frame.mouse_wheel_ = io.MouseWheel;
+        frame.mouse_wheel_h_ = io.MouseWheelH;
+        frame.mouse_down_ = 0;
+        frame.modifiers_ = 0;
+
+        for (int button = 0; button < ImGuiMouseButton_COUNT; ++button)
+            if (io.MouseDown[button])
+                frame.mouse_down_ |= 1 << button;
+
+        frame.modifiers_ |= io.KeyCtrl ? 1 << 0 : 0;
+        frame.modifiers_ |= io.KeyShift ? 1 << 1 : 0;
+        frame.modifiers_ |= io.KeyAlt ? 1 << 2 : 0;
+        frame.modifiers_ |= io.KeySuper ? 1 << 3 : 0;
+
+        // keyboard keys only, gamepad and the mouse/modifier aliases after them are not recorded
+        for (int key_idx = 0; key_idx < ImGuiNodesRecordKeys; ++key_idx)
+        {
+            const unsigned char down = ImGui::IsKeyDown(ImGuiKey(ImGuiKey_Tab + key_idx)) ? 1 : 0;
+
+            if (down != keys_down_[key_idx])
+            {
+                keys_down_[key_idx] = down;
+                frame.keys_.push_back({static_cast<unsigned short>(ImGuiKey_Tab + key_idx), down});
+            }
+        }
+    }
+
+    bool ImGuiNodesRecorder::Replay()
+    {
+        if (cursor_ >= frames_.size())
+            return false;
+
+        ImGuiIO &io = ImGui::GetIO();
+
+        // one event per input and frame, trickling would spread them over several frames
+        if (cursor_ == 0)
+        {
+            io.ConfigInputTrickleEventQueue = false;
+            io.DisplaySize = display_size_;
+        }
+
+        const ImGuiNodesInputFrame &frame = frames_[cursor_++];
+
+        io.DeltaTime = frame.delta_time_;
+        io.AddMousePosEvent(frame.mouse_pos_.x, frame.mouse_pos_.y);
+
+        for (int button = 0; button < ImGuiMouseButton_COUNT; ++button)
+            if ((frame.mouse_down_ ^ mouse_down_) & (1 << button))
+                io.AddMouseButtonEvent(button, frame.mouse_down_ & (1 << button));
+
+        const ImGuiKey modifiers[] = {ImGuiMod_Ctrl, ImGuiMod_Shift, ImGuiMod_Alt, ImGuiMod_Super};
+
+        for (int modifier_idx = 0; modifier_idx < IM_ARRAYSIZE(modifiers); ++modifier_idx)
+            if ((frame.modifiers_ ^ modifiers_) & (1 << modifier_idx))
+                io.AddKeyEvent(modifiers[modifier_idx], frame.modifiers_ & (1 << modifier_idx));
+
+        for (const ImGuiNodesInputKey &key : frame.keys_)
+            io.AddKeyEvent(ImGuiKey(key.key_), key.down_ != 0);
+
+        if (frame.mouse_wheel_ != 0.0f || frame.mouse_wheel_h_ != 0.0f)
+            io.AddMouseWheelEvent(frame.mouse_wheel_h_, frame.mouse_wheel_);
+
+        mouse_down_ = frame.mouse_down_;
+        modifiers_ = frame.modifiers_;
+
+        return true;
+    }
+
+    void ImGuiNodesRecorder::Rewind()
+    {
+        cursor_ = 0;
+        mouse_down_ = 0;
+        modifiers_ = 0;
+    }
+
+    void ImGuiNodesRecorder::Clear()
+    {
+        Rewind();
+
+        frames_.clear();
+        keys_down_.clear();
+    }
+
+    bool ImGuiNodesRecorder::Save(const char *path) const
+    {
+        FILE *file = fopen(path, "wb");
+        if (nullptr == file)
+            return false;
+
+        bool succeed = true;
+
+        succeed &= 1 == fwrite(ImGuiNodesRecordMagic, sizeof(ImGuiNodesRecordMagic), 1, file);
+        succeed &= WriteRecordValue(file, ImGuiNodesRecordVersion);
+        succeed &= WriteRecordValue(file, display_size_.x);
+        succeed &= WriteRecordValue(file, display_size_.y);
+        succeed &= WriteRecordValue(file, tag_);
+        succeed &= WriteRecordValue(file, static_cast<uint32_t>(frames_.size()));
+
+        for (size_t frame_idx = 0; succeed && frame_idx < frames_.size(); ++frame_idx)
+        {
+            const ImGuiNodesInputFrame &frame = frames_[frame_idx];
+
+            succeed &= WriteRecordValue(file, frame.delta_time_);
+            succeed &= WriteRecordValue(file, frame.mouse_pos_.x);
+            succeed &= WriteRecordValue(file, frame.mouse_pos_.y);
+            succeed &= WriteRecordValue(file, frame.mouse_wheel_);
+            succeed &= WriteRecordValue(file, frame.mouse_wheel_h_);
+            succeed &= WriteRecordValue(file, frame.mouse_down_);
+            succeed &= WriteRecordValue(file, frame.modifiers_);
+            succeed &= WriteRecordValue(file, static_cast<uint16_t>(frame.keys_.size()));
+
+            for (const ImGuiNodesInputKey &key : frame.keys_)
+            {
+                succeed &= WriteRecordValue(file, key.key_);
+                succeed &= WriteRecordValue(file, key.down_);
+            }
+        }
+
+        return 0 == fclose(file) && succeed;
+    }
+
+    bool ImGuiNodesRecorder::Load(const char *path)
+    {
+        FILE *file = fopen(path, "rb");
+        if (nullptr == file)
+            return false;
+
+        Clear();
+
+        char magic[sizeof(ImGuiNodesRecordMagic)];
+        uint32_t version = 0, frame_count = 0;
+
+        bool succeed = true;
+
+        succeed &= 1 == fread(magic, sizeof(magic), 1, file) && 0 == memcmp(magic, ImGuiNodesRecordMagic, sizeof(magic));
+        succeed &= ReadRecordValue(file, version) && version == ImGuiNodesRecordVersion;
+        succeed &= ReadRecordValue(file, display_size_.x);
+        succeed &= ReadRecordValue(file, display_size_.y);
+        succeed &= ReadRecordValue(file, tag_);
+        succeed &= ReadRecordValue(file, frame_count);
+
+        for (uint32_t frame_idx = 0; succeed && frame_idx < frame_count; ++frame_idx)
+        {
+            ImGuiNodesInputFrame &frame = frames_.emplace_back();
+            uint16_t key_count = 0;
+
+            succeed &= ReadRecordValue(file, frame.delta_time_);
+            succeed &= ReadRecordValue(file, frame.mouse_pos_.x);
+            succeed &= ReadRecordValue(file, frame.mouse_pos_.y);
+            succeed &= ReadRecordValue(file, frame.mouse_wheel_);
+            succeed &= ReadRecordValue(file, frame.mouse_wheel_h_);
+            succeed &= ReadRecordValue(file, frame.mouse_down_);
+            succeed &= ReadRecordValue(file, frame.modifiers_);
+            succeed &= ReadRecordValue(file, key_count);
+
+            for (uint16_t key_idx = 0; succeed && key_idx < key_count; ++key_idx)
+            {
+                ImGuiNodesInputKey &key = frame.keys_.emplace_back();
+
+                succeed &= ReadRecordValue(file, key.key_);
+                succeed &= ReadRecordValue(file, key.down_);
+            }
+        }
+
+        fclose(file);
+
+        if (!succeed)
+            Clear();
+
+        return succeed;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef IMGUI_NODES_RECORDER_H // !IMGUI_NODES_RECORDER_H
+#define IMGUI_NODES_RECORDER_H
+
+#include "ImGuiNodes.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ImGui
+{
+    ////////////////////////////////////////////////////////////////////////////////
+
+    struct ImGuiNodesInputKey
+    {
+        unsigned short key_;
+        unsigned char down_;
+    };
+
+    // input as seen by one ImGui::NewFrame(), keys only hold transitions
+    struct ImGuiNodesInputFrame
+    {
+        float delta_time_;
+        ImVec2 mouse_pos_;
+        float mouse_wheel_;
+        float mouse_wheel_h_;
+        unsigned char mouse_down_; // one bit per ImGuiMouseButton
+        unsigned char modifiers_;  // ctrl, shift, alt, super
+        std::vector<ImGuiNodesInputKey> keys_;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    struct ImGuiNodesRecorder
+    {
+    public:
+        ImVec2 display_size_;
+        uint64_t tag_ = 0; // identifies the graph the input was recorded against
+
+    private:
+        std::vector<ImGuiNodesInputFrame> frames_;
+        std::vector<unsigned char> keys_down_;
+        size_t cursor_ = 0;
+        unsigned char mouse_down_ = 0;
+        unsigned char modifiers_ = 0;
+
+    public:
+        // call right after ImGui::NewFrame()
+        void Record();
+
+        // call right before ImGui::NewFrame(), false once every frame was fed
+        bool Replay();
+
+        void Rewind();
+        void Clear();
+
+        bool Save(const char *path) const;
+        bool Load(const char *path);
+
+        size_t GetFrameCount() const { return frames_.size(); }
+        size_t GetFrameCursor() const { return cursor_; }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+}
+
+#if defined(IMGUI_NODES_HEADER_ONLY)
+#include "ImGuiNodesRecorder.cc"
+#endif
+
+#endif // !IMGUI_NODES_RECORDER_H
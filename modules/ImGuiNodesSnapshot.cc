@@ -0,0 +1,502 @@
+#include "ImGuiNodesSnapshot.h"
+
+#include <stdio.h>
+
+#include <memory>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ImGui
+{
+    bool ImGuiNodesMappedFile::Open(const char *path)
+    {
+        Close();
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (INVALID_HANDLE_VALUE == file)
+            return false;
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size) || 0 == size.QuadPart)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (nullptr == mapping)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (nullptr == data)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        file_ = file;
+        mapping_ = mapping;
+        data_ = static_cast<const unsigned char *>(data);
+        size_ = static_cast<size_t>(size.QuadPart);
+#else
+        int file = open(path, O_RDONLY);
+        if (-1 == file)
+            return false;
+
+        struct stat info{};
+        if (-1 == fstat(file, &info) || 0 == info.st_size)
+        {
+            close(file);
+            return false;
+        }
+
+        void *data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (MAP_FAILED == data)
+        {
+            close(file);
+            return false;
+        }
+
+        madvise(data, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+        file_ = file;
+        data_ = static_cast<const unsigned char *>(data);
+        size_ = static_cast<size_t>(info.st_size);
+#endif
+
+        return true;
+    }
+
+    void ImGuiNodesMappedFile::Close()
+    {
+#if defined(_WIN32)
+        if (data_)
+            UnmapViewOfFile(data_);
+
+        if (mapping_)
+            CloseHandle(mapping_);
+
+        if (file_)
+            CloseHandle(file_);
+
+        mapping_ = nullptr;
+        file_ = nullptr;
+#else
+        if (data_)
+            munmap(const_cast<unsigned char *>(data_), size_);
+
+        if (-1 != file_)
+            close(file_);
+
+        file_ = -1;
+#endif
+
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    static inline uint64_t AlignSnapshotOffset(uint64_t offset)
+    {
+        return (offset + ImGuiNodesSnapshotAlignment - 1) & ~(ImGuiNodesSnapshotAlignment - 1);
+    }
+
+    template <typename T>
+    static inline bool WriteSnapshotSection(FILE *file, uint64_t offset, const std::vector<T> &section)
+    {
+        static const unsigned char padding[ImGuiNodesSnapshotAlignment] = {};
+
+        const long position = ftell(file);
+        if (position < 0 || static_cast<uint64_t>(position) > offset)
+            return false;
+
+        if (offset != static_cast<uint64_t>(position) && 1 != fwrite(padding, offset - position, 1, file))
+            return false;
+
+        return section.empty() || section.size() == fwrite(section.data(), sizeof(T), section.size(), file);
+    }
+
+    template <typename T>
+    static inline const T *GetSnapshotSection(const ImGuiNodesMappedFile &file, uint64_t offset, uint64_t count)
+    {
+        if (offset % alignof(T) != 0 || offset > file.GetSize())
+            return nullptr;
+
+        if (count > (file.GetSize() - offset) / sizeof(T))
+            return nullptr;
+
+        return reinterpret_cast<const T *>(file.GetData() + offset);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    static bool ReadSnapshotSections(const ImGuiNodesMappedFile &file, ImGuiNodesSnapshotSections &sections)
+    {
+        const ImGuiNodesSnapshotHeader *header = GetSnapshotSection<ImGuiNodesSnapshotHeader>(file, 0, 1);
+        if (nullptr == header)
+            return false;
+
+        if (0 != memcmp(header->magic_, ImGuiNodesSnapshotMagic, sizeof(header->magic_)))
+            return false;
+
+        if (header->version_ < 1 || header->version_ > ImGuiNodesSnapshotVersion || header->byte_order_ != ImGuiNodesSnapshotByteOrder)
+            return false;
+
+        sections.scroll_ = header->scroll_;
+        sections.scale_ = header->scale_;
+
+        sections.descs_ = GetSnapshotSection<ImGuiNodesSnapshotDesc>(file, header->desc_offset_, header->desc_count_);
+        sections.connectors_ = GetSnapshotSection<ImGuiNodesConnectionDesc>(file, header->connector_offset_, header->connector_count_);
+        sections.nodes_ = GetSnapshotSection<ImGuiNodesSnapshotNode>(file, header->node_offset_, header->node_count_);
+        sections.edges_ = GetSnapshotSection<ImGuiNodesEdge>(file, header->edge_offset_, header->edge_count_);
+        sections.names_ = GetSnapshotSection<char>(file, header->names_offset_, header->names_size_);
+
+        if (!sections.descs_ || !sections.connectors_ || !sections.nodes_ || !sections.edges_ || !sections.names_)
+            return false;
+
+        sections.desc_count_ = header->desc_count_;
+        sections.connector_count_ = header->connector_count_;
+        sections.node_count_ = header->node_count_;
+        sections.edge_count_ = header->edge_count_;
+        sections.names_size_ = header->names_size_;
+
+        // the reserved field of version 1 is not an id
+        if (header->version_ < 2)
+            for (uint64_t node_idx = 0; node_idx < sections.node_count_; ++node_idx)
+                if (0 != sections.nodes_[node_idx].id_)
+                    return false;
+
+        return true;
+    }
+
+    static void SyncFile(FILE *file)
+    {
+#if defined(_WIN32)
+        _commit(_fileno(file));
+#else
+        fsync(fileno(file));
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    bool ImGuiNodesSnapshotSections::Validate() const
+    {
+        if (node_count_ > UINT32_MAX)
+            return false;
+
+        if (names_size_ > 0 && '\0' != names_[names_size_ - 1])
+            return false;
+
+        for (uint64_t desc_idx = 0; desc_idx < desc_count_; ++desc_idx)
+        {
+            const ImGuiNodesSnapshotDesc &desc = descs_[desc_idx];
+
+            if (uint64_t(desc.first_connector_) + desc.input_count_ + desc.output_count_ > connector_count_)
+                return false;
+
+            if (nullptr == memchr(desc.name_, '\0', sizeof(desc.name_)))
+                return false;
+        }
+
+        for (uint64_t connector_idx = 0; connector_idx < connector_count_; ++connector_idx)
+            if (nullptr == memchr(connectors_[connector_idx].name_, '\0', sizeof(connectors_[connector_idx].name_)))
+                return false;
+
+        for (uint64_t node_idx = 0; node_idx < node_count_; ++node_idx)
+        {
+            if (nodes_[node_idx].desc_ >= desc_count_)
+                return false;
+
+            if (nodes_[node_idx].name_ > names_size_)
+                return false;
+        }
+
+        for (uint64_t edge_idx = 0; edge_idx < edge_count_; ++edge_idx)
+            if (edges_[edge_idx].output_node_ >= node_count_ || edges_[edge_idx].input_node_ >= node_count_)
+                return false;
+
+        return true;
+    }
+
+    ImGuiNodesSnapshotSections ImGuiNodesSnapshotData::GetSections() const
+    {
+        ImGuiNodesSnapshotSections sections;
+        sections.scroll_ = scroll_;
+        sections.scale_ = scale_;
+
+        sections.descs_ = descs_.data();
+        sections.connectors_ = connectors_.data();
+        sections.nodes_ = nodes_.data();
+        sections.edges_ = edges_.data();
+        sections.names_ = names_.data();
+
+        sections.desc_count_ = descs_.size();
+        sections.connector_count_ = connectors_.size();
+        sections.node_count_ = nodes_.size();
+        sections.edge_count_ = edges_.size();
+        sections.names_size_ = names_.size();
+
+        return sections;
+    }
+
+    bool ImGuiNodesSnapshotData::Read(const char *path)
+    {
+        ImGuiNodesMappedFile file;
+        if (!file.Open(path))
+            return false;
+
+        ImGuiNodesSnapshotSections sections;
+        if (!ReadSnapshotSections(file, sections) || !sections.Validate())
+            return false;
+
+        scroll_ = sections.scroll_;
+        scale_ = sections.scale_;
+
+        descs_.assign(sections.descs_, sections.descs_ + sections.desc_count_);
+        connectors_.assign(sections.connectors_, sections.connectors_ + sections.connector_count_);
+        nodes_.assign(sections.nodes_, sections.nodes_ + sections.node_count_);
+        edges_.assign(sections.edges_, sections.edges_ + sections.edge_count_);
+        names_.assign(sections.names_, sections.names_ + sections.names_size_);
+
+        return true;
+    }
+
+    bool ImGuiNodesSnapshotData::Write(const char *path, bool sync) const
+    {
+        ImGuiNodesSnapshotHeader header{};
+        memcpy(header.magic_, ImGuiNodesSnapshotMagic, sizeof(header.magic_));
+        header.version_ = ImGuiNodesSnapshotVersion;
+        header.byte_order_ = ImGuiNodesSnapshotByteOrder;
+        header.scroll_ = scroll_;
+        header.scale_ = scale_;
+
+        header.desc_count_ = descs_.size();
+        header.connector_count_ = connectors_.size();
+        header.node_count_ = nodes_.size();
+        header.edge_count_ = edges_.size();
+        header.names_size_ = names_.size();
+
+        header.desc_offset_ = AlignSnapshotOffset(sizeof(header));
+        header.connector_offset_ = AlignSnapshotOffset(header.desc_offset_ + descs_.size() * sizeof(ImGuiNodesSnapshotDesc));
+        header.node_offset_ = AlignSnapshotOffset(header.connector_offset_ + connectors_.size() * sizeof(ImGuiNodesConnectionDesc));
+        header.edge_offset_ = AlignSnapshotOffset(header.node_offset_ + nodes_.size() * sizeof(ImGuiNodesSnapshotNode));
+        header.names_offset_ = AlignSnapshotOffset(header.edge_offset_ + edges_.size() * sizeof(ImGuiNodesEdge));
+
+        FILE *file = fopen(path, "wb");
+        if (nullptr == file)
+            return false;
+
+        bool succeed = 1 == fwrite(&header, sizeof(header), 1, file);
+
+        succeed = succeed && WriteSnapshotSection(file, header.desc_offset_, descs_);
+        succeed = succeed && WriteSnapshotSection(file, header.connector_offset_, connectors_);
+        succeed = succeed && WriteSnapshotSection(file, header.node_offset_, nodes_);
+        succeed = succeed && WriteSnapshotSection(file, header.edge_offset_, edges_);
+        succeed = succeed && WriteSnapshotSection(file, header.names_offset_, names_);
+
+        if (succeed && sync)
+        {
+            succeed = 0 == fflush(file);
+            SyncFile(file);
+        }
+
+        return 0 == fclose(file) && succeed;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    bool ImGuiNodes::SaveSnapshot(ImGuiNodesSnapshotData &data) const
+    {
+        data = {};
+        data.scroll_ = scroll_;
+        data.scale_ = scale_;
+
+        std::unordered_map<const ImGuiNodesNodeDesc *, uint32_t> desc_indices;
+        std::unordered_map<const ImGuiNodesNode *, uint32_t> node_indices;
+
+        data.descs_.reserve(nodes_desc_.size());
+        desc_indices.reserve(nodes_desc_.size());
+        data.nodes_.reserve(nodes_.size());
+        node_indices.reserve(nodes_.size());
+
+        for (const ImGuiNodesNodeDesc &desc : nodes_desc_)
+        {
+            ImGuiNodesSnapshotDesc &record = data.descs_.emplace_back();
+            memcpy(record.name_, desc.name_, sizeof(record.name_));
+            record.type_ = desc.type_;
+            record.color_ = desc.color_.Value;
+            record.first_connector_ = static_cast<uint32_t>(data.connectors_.size());
+            record.input_count_ = static_cast<uint32_t>(desc.inputs_.size());
+            record.output_count_ = static_cast<uint32_t>(desc.outputs_.size());
+            record.reserved_ = 0;
+
+            data.connectors_.insert(data.connectors_.end(), desc.inputs_.begin(), desc.inputs_.end());
+            data.connectors_.insert(data.connectors_.end(), desc.outputs_.begin(), desc.outputs_.end());
+
+            desc_indices.emplace(&desc, static_cast<uint32_t>(data.descs_.size() - 1));
+        }
+
+        for (const ImGuiNodesNode *node : nodes_)
+        {
+            auto desc = desc_indices.find(node->desc_);
+            if (desc == desc_indices.end())
+                return false;
+
+            ImGuiNodesSnapshotNode &record = data.nodes_.emplace_back();
+            record.pos_ = node->area_node_.Min;
+            record.desc_ = desc->second;
+            record.state_ = node->state_ & ImGuiNodesSnapshotNodeStateMask;
+            record.name_ = 0;
+            record.id_ = node->id_;
+
+            if (node->name_ != node->desc_->name_)
+            {
+                record.name_ = static_cast<uint32_t>(data.names_.size() + 1);
+                data.names_.insert(data.names_.end(), node->name_, node->name_ + strlen(node->name_) + 1);
+            }
+
+            node_indices.emplace(node, static_cast<uint32_t>(data.nodes_.size() - 1));
+        }
+
+        for (const ImGuiNodesNode *node : nodes_)
+        {
+            for (size_t input_idx = 0; input_idx < node->inputs_.size(); ++input_idx)
+            {
+                const ImGuiNodesInput &input = node->inputs_[input_idx];
+
+                if (nullptr == input.target_ || nullptr == input.output_)
+                    continue;
+
+                data.edges_.push_back(
+                    {
+                        node_indices.at(input.target_),
+                        static_cast<uint32_t>(input.output_ - input.target_->outputs_.data()),
+                        node_indices.at(node),
+                        static_cast<uint32_t>(input_idx),
+                    });
+            }
+        }
+
+        return true;
+    }
+
+    bool ImGuiNodes::SaveSnapshot(const char *path) const
+    {
+        ImGuiNodesSnapshotData data;
+
+        return SaveSnapshot(data) && data.Write(path);
+    }
+
+    void ImGuiNodes::RegisterSnapshotDescs(const ImGuiNodesSnapshotSections &sections, std::vector<ImGuiNodesNodeDesc *> &node_descs)
+    {
+        node_descs.resize(sections.desc_count_);
+
+        for (uint64_t desc_idx = 0; desc_idx < sections.desc_count_; ++desc_idx)
+        {
+            const ImGuiNodesSnapshotDesc &record = sections.descs_[desc_idx];
+            const ImGuiNodesConnectionDesc *connectors = sections.connectors_ + record.first_connector_;
+
+            ImGuiNodesNodeDesc desc;
+            memcpy(desc.name_, record.name_, sizeof(desc.name_));
+
+            auto it = nodes_desc_.find(desc);
+            if (it == nodes_desc_.end())
+            {
+                desc.type_ = record.type_;
+                desc.color_ = ImColor(record.color_);
+                desc.inputs_.assign(connectors, connectors + record.input_count_);
+                desc.outputs_.assign(connectors + record.input_count_, connectors + record.input_count_ + record.output_count_);
+
+                it = nodes_desc_.insert(std::move(desc)).first;
+            }
+
+            node_descs[desc_idx] = const_cast<ImGuiNodesNodeDesc *>(&*it);
+        }
+    }
+
+    bool ImGuiNodes::LoadSnapshot(const ImGuiNodesSnapshotSections &sections)
+    {
+        // validate everything up front, the current graph is only dropped once the sections are known to be good
+        if (!sections.Validate())
+            return false;
+
+        std::vector<ImGuiNodesNodeDesc *> node_descs;
+        RegisterSnapshotDescs(sections, node_descs);
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        ImGuiNodesBatch batch;
+        batch.top_left_ = true;
+        batch.Reserve(sections.node_count_, sections.edge_count_);
+
+        const char *pool = nullptr;
+
+        if (sections.names_size_ > 0)
+        {
+            char *copy = batch.names_.emplace_back(new char[sections.names_size_]).get();
+            memcpy(copy, sections.names_, sections.names_size_);
+            pool = copy;
+        }
+
+        for (uint64_t node_idx = 0; node_idx < sections.node_count_; ++node_idx)
+        {
+            const ImGuiNodesSnapshotNode &record = sections.nodes_[node_idx];
+
+            const uint32_t index = batch.AddNode(node_descs[record.desc_], record.pos_, record.state_ & ImGuiNodesSnapshotNodeStateMask, record.name_ ? pool + record.name_ - 1 : nullptr);
+            batch.nodes_[index].id_ = record.id_;
+        }
+
+        batch.AddEdges(sections.edges_, sections.edge_count_);
+
+        ////////////////////////////////////////////////////////////////////////////////
+
+        for (ImGuiNodesNode *node : nodes_)
+            delete node;
+
+        // the listener hears of the load once, with the graph it ends up with
+        Reset();
+        name_pool_.clear();
+
+        state_ = ImGuiNodesState_Default;
+        connection_ = ImVec4();
+
+        BuildBatch(batch);
+
+        scroll_ = sections.scroll_;
+        scale_ = ImClamp(sections.scale_, 0.3f, 3.0f);
+
+        if (listener_)
+            listener_->OnReset(*this);
+
+        return true;
+    }
+
+    bool ImGuiNodes::LoadSnapshot(const char *path)
+    {
+        ImGuiNodesMappedFile file;
+        if (!file.Open(path))
+            return false;
+
+        ImGuiNodesSnapshotSections sections;
+        if (!ReadSnapshotSections(file, sections))
+            return false;
+
+        return LoadSnapshot(sections);
+    }
+}
@@ -0,0 +1,153 @@
+#ifndef IMGUI_NODES_SNAPSHOT_H // !IMGUI_NODES_SNAPSHOT_H
+#define IMGUI_NODES_SNAPSHOT_H
+
+#include "ImGuiNodes.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ImGui
+{
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // ImGuiNodes::SaveSnapshot() file layout, host byte order, every section starts on ImGuiNodesSnapshotAlignment:
+    // header, desc table, connector table, node table, edge list, NUL terminated names
+    // version 2 stores the stable node ids, version 1 files still load and get fresh ids
+    constexpr char ImGuiNodesSnapshotMagic[8] = {'I', 'G', 'N', 'S', 'N', 'A', 'P', '\0'};
+    constexpr uint32_t ImGuiNodesSnapshotVersion = 2;
+    constexpr uint32_t ImGuiNodesSnapshotByteOrder = 0x01020304;
+    constexpr uint64_t ImGuiNodesSnapshotAlignment = 16;
+
+    struct ImGuiNodesSnapshotHeader
+    {
+        char magic_[8];
+        uint32_t version_;
+        uint32_t byte_order_;
+
+        ImVec2 scroll_;
+        float scale_;
+        uint32_t reserved_;
+
+        uint64_t desc_count_;
+        uint64_t connector_count_;
+        uint64_t node_count_;
+        uint64_t edge_count_;
+        uint64_t names_size_;
+
+        uint64_t desc_offset_;
+        uint64_t connector_offset_;
+        uint64_t node_offset_;
+        uint64_t edge_offset_;
+        uint64_t names_offset_;
+    };
+
+    // inputs then outputs, first_connector_ indexes the connector table of ImGuiNodesConnectionDesc
+    struct ImGuiNodesSnapshotDesc
+    {
+        char name_[ImGuiNodesNamesMaxLen];
+        uint32_t type_;
+        ImVec4 color_;
+        uint32_t first_connector_;
+        uint32_t input_count_;
+        uint32_t output_count_;
+        uint32_t reserved_;
+    };
+
+    // name_ is an offset into the names section plus one, zero keeps the desc name
+    struct ImGuiNodesSnapshotNode
+    {
+        ImVec2 pos_;
+        uint32_t desc_;
+        uint32_t state_;
+        uint32_t name_;
+        uint32_t id_; // ImGuiNodesNode::id_, zero in version 1
+    };
+
+    static_assert(sizeof(ImGuiNodesConnectionDesc) == 32);
+    static_assert(sizeof(ImGuiNodesSnapshotDesc) == 64);
+    static_assert(sizeof(ImGuiNodesSnapshotNode) == 24);
+    static_assert(sizeof(ImGuiNodesEdge) == 16);
+
+    // only these survive a save and load, the rest is interaction state
+    constexpr ImGuiNodesNodeState ImGuiNodesSnapshotNodeStateMask = ImGuiNodesNodeStateFlag_Collapsed | ImGuiNodesNodeStateFlag_Disabled | ImGuiNodesNodeStateFlag_Selected;
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // read-only view of a whole file, mmap on POSIX and a file mapping on Windows
+    struct ImGuiNodesMappedFile
+    {
+    private:
+        const unsigned char *data_ = nullptr;
+        size_t size_ = 0;
+
+#if defined(_WIN32)
+        void *file_ = nullptr;
+        void *mapping_ = nullptr;
+#else
+        int file_ = -1;
+#endif
+
+    public:
+        bool Open(const char *path);
+        void Close();
+
+        const unsigned char *GetData() const { return data_; }
+        size_t GetSize() const { return size_; }
+
+        ImGuiNodesMappedFile() = default;
+        ImGuiNodesMappedFile(const ImGuiNodesMappedFile &) = delete;
+        ImGuiNodesMappedFile &operator=(const ImGuiNodesMappedFile &) = delete;
+        ~ImGuiNodesMappedFile() { Close(); }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // the sections of a snapshot wherever they live, a mapped file or an ImGuiNodesSnapshotData
+    struct ImGuiNodesSnapshotSections
+    {
+        ImVec2 scroll_;
+        float scale_ = 1.0f;
+
+        const ImGuiNodesSnapshotDesc *descs_ = nullptr;
+        const ImGuiNodesConnectionDesc *connectors_ = nullptr;
+        const ImGuiNodesSnapshotNode *nodes_ = nullptr;
+        const ImGuiNodesEdge *edges_ = nullptr;
+        const char *names_ = nullptr;
+
+        uint64_t desc_count_ = 0;
+        uint64_t connector_count_ = 0;
+        uint64_t node_count_ = 0;
+        uint64_t edge_count_ = 0;
+        uint64_t names_size_ = 0;
+
+        // every index in bounds and every string terminated
+        bool Validate() const;
+    };
+
+    // snapshot sections held in memory, e.g. gathered on the UI thread and written out by another one
+    struct ImGuiNodesSnapshotData
+    {
+        ImVec2 scroll_;
+        float scale_ = 1.0f;
+
+        std::vector<ImGuiNodesSnapshotDesc> descs_;
+        std::vector<ImGuiNodesConnectionDesc> connectors_;
+        std::vector<ImGuiNodesSnapshotNode> nodes_;
+        std::vector<ImGuiNodesEdge> edges_;
+        std::vector<char> names_;
+
+        ImGuiNodesSnapshotSections GetSections() const;
+
+        bool Read(const char *path);
+        // sync flushes the file to the disk before returning
+        bool Write(const char *path, bool sync = false) const;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+}
+
+#if defined(IMGUI_NODES_HEADER_ONLY)
+#include "ImGuiNodesSnapshot.cc"
+#endif
+
+#endif // !IMGUI_NODES_SNAPSHOT_H
@@ -0,0 +1,79 @@
+#include "ImGuiNodesTrace.h"
+
+#include <stdio.h>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace ImGui
+{
+    ImGuiNodesTrace &ImGuiNodesTrace::Get()
+    {
+        static ImGuiNodesTrace trace;
+        return trace;
+    }
+
+    uint64_t ImGuiNodesTrace::Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void ImGuiNodesTrace::Record(const char *name, uint64_t begin, uint64_t end)
+    {
+        static thread_local const uint32_t thread = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        const uint64_t slot = head_.fetch_add(1, std::memory_order_relaxed);
+
+        events_[slot % Capacity] = {name, begin, end, thread};
+    }
+
+    void ImGuiNodesTrace::Clear()
+    {
+        head_.store(0, std::memory_order_relaxed);
+    }
+
+    size_t ImGuiNodesTrace::GetEventCount() const
+    {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        return head < Capacity ? static_cast<size_t>(head) : Capacity;
+    }
+
+    bool ImGuiNodesTrace::Dump(const char *path) const
+    {
+        FILE *file = fopen(path, "wb");
+        if (nullptr == file)
+            return false;
+
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        const uint64_t first = head < Capacity ? 0 : head - Capacity;
+
+        fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+
+        for (uint64_t event_idx = first; event_idx < head; ++event_idx)
+        {
+            const ImGuiNodesTraceEvent &event = events_[event_idx % Capacity];
+
+            fputs(event_idx == first ? "\n{\"name\":\"" : ",\n{\"name\":\"", file);
+
+            for (const char *c = event.name_; *c; ++c)
+            {
+                if (*c == '"' || *c == '\\')
+                    fputc('\\', file);
+
+                fputc(*c, file);
+            }
+
+            fprintf(
+                file,
+                "\",\"cat\":\"ImGuiNodes\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}",
+                event.begin_ / 1000.0,
+                (event.end_ - event.begin_) / 1000.0,
+                event.thread_);
+        }
+
+        fputs("\n]}\n", file);
+
+        return 0 == fclose(file);
+    }
+}
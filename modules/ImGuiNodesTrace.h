@@ -0,0 +1,71 @@
+#ifndef IMGUI_NODES_TRACE_H // !IMGUI_NODES_TRACE_H
+#define IMGUI_NODES_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace ImGui
+{
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // name_ must outlive the trace, scopes are meant to be named by string literals
+    struct ImGuiNodesTraceEvent
+    {
+        const char *name_;
+        uint64_t begin_; // nanoseconds on the steady clock
+        uint64_t end_;
+        uint32_t thread_;
+    };
+
+    // process wide ring buffer, the oldest events are overwritten once it is full
+    struct ImGuiNodesTrace
+    {
+    public:
+        static constexpr size_t Capacity = 1 << 16;
+
+    private:
+        std::unique_ptr<ImGuiNodesTraceEvent[]> events_;
+        std::atomic<uint64_t> head_ = 0;
+
+    public:
+        static ImGuiNodesTrace &Get();
+        static uint64_t Now();
+
+        void Record(const char *name, uint64_t begin, uint64_t end);
+        void Clear();
+
+        // Chrome trace event JSON, opens in chrome://tracing and Perfetto, call while nothing records
+        bool Dump(const char *path) const;
+
+        size_t GetEventCount() const;
+
+        ImGuiNodesTrace() : events_(new ImGuiNodesTraceEvent[Capacity]) {}
+    };
+
+    struct ImGuiNodesTraceScope
+    {
+        const char *name_;
+        uint64_t begin_;
+
+        ImGuiNodesTraceScope(const char *name) : name_(name), begin_(ImGuiNodesTrace::Now()) {}
+        ~ImGuiNodesTraceScope() { ImGuiNodesTrace::Get().Record(name_, begin_, ImGuiNodesTrace::Now()); }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////
+}
+
+#define IMGUI_NODES_TRACE_CONCAT_IMPL(a, b) a##b
+#define IMGUI_NODES_TRACE_CONCAT(a, b) IMGUI_NODES_TRACE_CONCAT_IMPL(a, b)
+
+#if defined(IMGUI_NODES_ENABLE_TRACE)
+#define IMGUI_NODES_TRACE_SCOPE(name) ImGui::ImGuiNodesTraceScope IMGUI_NODES_TRACE_CONCAT(imgui_nodes_trace_scope_, __LINE__)(name)
+#else
+#define IMGUI_NODES_TRACE_SCOPE(name) ((void)0)
+#endif
+
+#if defined(IMGUI_NODES_HEADER_ONLY)
+#include "ImGuiNodesTrace.cc"
+#endif
+
+#endif // !IMGUI_NODES_TRACE_H
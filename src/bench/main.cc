@@ -0,0 +1,1028 @@
+#include <modules/ImGuiNodes.h>
+#include <modules/ImGuiNodesLayout.h>
+#include <modules/ImGuiNodesPager.h>
+#include <modules/ImGuiNodesRecorder.h>
+#include <includes/BenchmarkGraph.h>
+#include <includes/ObjectRelationLayout.h>
+
+#include <imgui/imgui.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#define DISPLAY_WIDTH 1920
+#define DISPLAY_HEIGHT 1080
+
+struct BenchmarkScene
+{
+    const char *name;
+    ImVec2 scroll;
+    float scale;
+    ImVec2 scrollPerFrame;
+    float scalePerFrame;
+};
+
+struct FrameSample
+{
+    double milliseconds;
+    int vertices;
+    int indices;
+};
+
+// Every heap allocation of the process, operator new and the imgui allocator both end up here
+std::atomic<size_t> g_allocations = 0;
+
+// The replacements below only call these two, kept out of line so the compiler never pairs a
+// malloc it cannot see with a free it inlined and warns about mismatched new and delete
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+BENCH_NOINLINE void *CountedAllocate(size_t size, size_t alignment) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    size = size ? size : 1;
+
+    if (alignment <= alignof(std::max_align_t))
+        return std::malloc(size);
+
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#else
+    // aligned_alloc wants a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+}
+
+BENCH_NOINLINE void CountedRelease(void *pointer, [[maybe_unused]] size_t alignment) noexcept
+{
+#if defined(_WIN32)
+    if (alignment > alignof(std::max_align_t))
+        return _aligned_free(pointer);
+#endif
+
+    std::free(pointer);
+}
+
+void *operator new(size_t size)
+{
+    if (void *pointer = CountedAllocate(size, 0))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    if (void *pointer = CountedAllocate(size, static_cast<size_t>(alignment)))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return CountedAllocate(size, 0);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return CountedAllocate(size, 0);
+}
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return CountedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return CountedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept
+{
+    CountedRelease(pointer, 0);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    CountedRelease(pointer, 0);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    CountedRelease(pointer, 0);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+    CountedRelease(pointer, 0);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept
+{
+    CountedRelease(pointer, 0);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept
+{
+    CountedRelease(pointer, 0);
+}
+
+void operator delete(void *pointer, std::align_val_t alignment) noexcept
+{
+    CountedRelease(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void *pointer, std::align_val_t alignment) noexcept
+{
+    CountedRelease(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *pointer, size_t, std::align_val_t alignment) noexcept
+{
+    CountedRelease(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void *pointer, size_t, std::align_val_t alignment) noexcept
+{
+    CountedRelease(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *pointer, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    CountedRelease(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void *pointer, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    CountedRelease(pointer, static_cast<size_t>(alignment));
+}
+
+void *CountingImGuiAlloc(size_t size, void *)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size);
+}
+
+void CountingImGuiFree(void *pointer, void *)
+{
+    std::free(pointer);
+}
+
+size_t CountAllocations(void *)
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+size_t GetPeakMemory()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss;
+#else
+    return usage.ru_maxrss * 1024ull;
+#endif
+#endif
+}
+
+void InitializeImGui()
+{
+    ImGui::SetAllocatorFunctions(CountingImGuiAlloc, CountingImGuiFree);
+    ImGui::CreateContext();
+
+    auto &imguiIO = ImGui::GetIO();
+
+    imguiIO.IniFilename = nullptr;
+    imguiIO.LogFilename = nullptr;
+    imguiIO.DisplaySize = ImVec2{static_cast<float>(DISPLAY_WIDTH), static_cast<float>(DISPLAY_HEIGHT)};
+    imguiIO.DeltaTime = 1.f / 60.f;
+
+    // Null renderer, draw data is only counted and large lists must not trip the 16-bit index assert
+    imguiIO.BackendRendererName = "imgui_impl_null";
+    imguiIO.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+
+    unsigned char *pixels = nullptr;
+    int width = 0, height = 0;
+    imguiIO.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+}
+
+FrameSample RunFrame(ImGui::ImGuiNodes &nodes)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    ImGui::NewFrame();
+    BenchmarkGraph::ShowWindow(nodes);
+    ImGui::Render();
+
+    auto stop = std::chrono::steady_clock::now();
+
+    ImDrawData *drawData = ImGui::GetDrawData();
+
+    return {
+        std::chrono::duration<double, std::milli>(stop - start).count(),
+        drawData->TotalVtxCount,
+        drawData->TotalIdxCount,
+    };
+}
+
+// Round trips through a snapshot and a JSON file, the imported graph replaces the built one for the frame scenes
+void RunSnapshot(ImGui::ImGuiNodes &nodes)
+{
+    const char *path = "bench.snapshot";
+
+    auto saveStart = std::chrono::steady_clock::now();
+    bool saved = nodes.SaveSnapshot(path);
+    auto saveStop = std::chrono::steady_clock::now();
+
+    ImGui::NewFrame();
+    auto loadStart = std::chrono::steady_clock::now();
+    bool loaded = saved && nodes.LoadSnapshot(path);
+    auto loadStop = std::chrono::steady_clock::now();
+    ImGui::EndFrame();
+
+    if (!loaded)
+    {
+        std::printf("    [-] snapshot round trip failed\n");
+        return;
+    }
+
+    FILE *file = std::fopen(path, "rb");
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fclose(file);
+    std::remove(path);
+
+    std::printf(
+        "    snapshot %.1f MiB, save %.2f ms, load %.2f ms\n",
+        size / (1024.0 * 1024.0),
+        std::chrono::duration<double, std::milli>(saveStop - saveStart).count(),
+        std::chrono::duration<double, std::milli>(loadStop - loadStart).count());
+}
+
+// Exports the graph and imports it again, same as RunSnapshot() but through the streamed JSON format
+void RunJson(ImGui::ImGuiNodes &nodes)
+{
+    const char *path = "bench.json";
+
+    auto exportStart = std::chrono::steady_clock::now();
+    bool exported = nodes.ExportJson(path);
+    auto exportStop = std::chrono::steady_clock::now();
+
+    ImGui::NewFrame();
+    auto importStart = std::chrono::steady_clock::now();
+    bool imported = exported && nodes.ImportJson(path);
+    auto importStop = std::chrono::steady_clock::now();
+    ImGui::EndFrame();
+
+    if (!imported)
+    {
+        std::printf("    [-] json round trip failed\n");
+        return;
+    }
+
+    FILE *file = std::fopen(path, "rb");
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fclose(file);
+    std::remove(path);
+
+    double megabytes = size / (1024.0 * 1024.0);
+    double exportTime = std::chrono::duration<double, std::milli>(exportStop - exportStart).count();
+    double importTime = std::chrono::duration<double, std::milli>(importStop - importStart).count();
+
+    std::printf(
+        "    json %.1f MiB, export %.2f ms (%.0f MiB/s), import %.2f ms (%.0f MiB/s)\n",
+        megabytes,
+        exportTime,
+        megabytes / (exportTime / 1000.0),
+        importTime,
+        megabytes / (importTime / 1000.0));
+}
+
+// Imports a JSON graph written by another tool, reports read throughput and the resulting peak memory
+bool RunImport(const char *path)
+{
+    ImGui::ImGuiNodes nodes;
+
+    FILE *file = std::fopen(path, "rb");
+    if (nullptr == file)
+    {
+        std::printf("[-] Can not open %s\n", path);
+        return false;
+    }
+
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fclose(file);
+
+    ImGui::NewFrame();
+    auto importStart = std::chrono::steady_clock::now();
+    bool imported = nodes.ImportJson(path);
+    auto importStop = std::chrono::steady_clock::now();
+    ImGui::EndFrame();
+
+    if (!imported)
+    {
+        std::printf("[-] %s is not an ImGuiNodes JSON document\n", path);
+        return false;
+    }
+
+    double megabytes = size / (1024.0 * 1024.0);
+    double importTime = std::chrono::duration<double, std::milli>(importStop - importStart).count();
+
+    std::printf(
+        "[+] %s: %zu nodes, %.1f MiB in %.2f ms (%.0f MiB/s), peak memory %.1f MiB\n",
+        path,
+        nodes.GetNodes().size(),
+        megabytes,
+        importTime,
+        megabytes / (importTime / 1000.0),
+        GetPeakMemory() / (1024.0 * 1024.0));
+
+    return true;
+}
+
+double Percentile(std::vector<double> &values, double percentile)
+{
+    size_t index = static_cast<size_t>(percentile * (values.size() - 1) + 0.5);
+
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// False when the editor allocated on the heap once a scene reached its steady state
+bool RunBenchmark(size_t nodeCount, int frames)
+{
+    ImGui::ImGuiNodes nodes;
+    BenchmarkGraph::RegisterNodeDesc(nodes);
+    nodes.SetAllocCounter(CountAllocations);
+
+    // Filling the batch needs no frame, building it measures text so that happens inside one like the demo does
+    auto batchStart = std::chrono::steady_clock::now();
+    BenchmarkGraph::MakeGraph(nodes, nodeCount);
+    auto batchStop = std::chrono::steady_clock::now();
+
+    auto buildStart = std::chrono::steady_clock::now();
+    ImGui::NewFrame();
+    nodes.FlushBatches();
+    ImGui::EndFrame();
+    auto buildStop = std::chrono::steady_clock::now();
+
+    std::printf(
+        "\n[+] %zu nodes, batch %.2f ms, build %.2f ms\n",
+        nodeCount,
+        std::chrono::duration<double, std::milli>(batchStop - batchStart).count(),
+        std::chrono::duration<double, std::milli>(buildStop - buildStart).count());
+
+    RunSnapshot(nodes);
+    RunJson(nodes);
+    std::printf("    %-10s %10s %10s %10s %10s %12s %12s %8s\n", "scene", "p50 ms", "p90 ms", "p99 ms", "max ms", "vertices", "indices", "allocs");
+
+    const BenchmarkScene scenes[] = {
+        {"overview", {0.f, 0.f}, 0.3f, {0.f, 0.f}, 1.0f},
+        {"default", {0.f, 0.f}, 1.0f, {0.f, 0.f}, 1.0f},
+        {"closeup", {-1000.f, -1000.f}, 3.0f, {0.f, 0.f}, 1.0f},
+        {"pan", {0.f, 0.f}, 1.0f, {-24.f, -12.f}, 1.0f},
+        {"zoom", {0.f, 0.f}, 0.5f, {0.f, 0.f}, 1.01f},
+    };
+
+    bool allocationFree = true;
+
+    for (const auto &scene : scenes)
+    {
+        nodes.SetScale(scene.scale);
+        nodes.SetScroll(scene.scroll);
+
+        // Warm up so vectors and the frame arena reach their steady capacity
+        RunFrame(nodes);
+
+        std::vector<double> times;
+        times.reserve(frames);
+
+        FrameSample last{};
+        size_t allocations = 0;
+
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            ImVec2 scroll = nodes.GetScroll();
+            nodes.SetScroll({scroll.x + scene.scrollPerFrame.x, scroll.y + scene.scrollPerFrame.y});
+            nodes.SetScale(nodes.GetScale() * scene.scalePerFrame);
+
+            last = RunFrame(nodes);
+            times.push_back(last.milliseconds);
+            allocations += nodes.GetStats().allocations_;
+        }
+
+        if (allocations > 0)
+            allocationFree = false;
+
+        double maximum = *std::max_element(times.begin(), times.end());
+
+        std::printf(
+            "    %-10s %10.3f %10.3f %10.3f %10.3f %12d %12d %8zu\n",
+            scene.name,
+            Percentile(times, 0.50),
+            Percentile(times, 0.90),
+            Percentile(times, 0.99),
+            maximum,
+            last.vertices,
+            last.indices,
+            allocations);
+
+        const auto &stats = nodes.GetStats();
+
+        std::printf(
+            "    %-10s canvas %.3f, hit test %.3f, state %.3f, draw %.3f ms, nodes %d/%d, wires %d/%d visible/culled\n",
+            "",
+            stats.canvas_geometry_time_,
+            stats.nodes_from_canvas_time_,
+            stats.state_machine_time_,
+            stats.process_nodes_time_,
+            stats.visible_nodes_,
+            stats.culled_nodes_,
+            stats.visible_wires_,
+            stats.culled_wires_);
+    }
+
+    std::printf("    peak memory %.1f MiB\n", GetPeakMemory() / (1024.0 * 1024.0));
+
+    return allocationFree;
+}
+
+// Producer threads stream nodes and connections into the command queue while frames run, every producer
+// chains its nodes and removes some of them again, the editor applies them within its frame budget
+void RunIngest(size_t nodeCount, int producers)
+{
+    ImGui::ImGuiNodes nodes;
+    BenchmarkGraph::RegisterNodeDesc(nodes);
+
+    ImGui::ImGuiNodesNodeDesc *desc = nodes.FindNodeDesc("Benchmark");
+    ImGui::ImGuiNodesCommandQueue &queue = nodes.GetCommandQueue();
+
+    std::printf("\n[+] ingest %zu nodes from %d threads, budget %.1f ms\n", nodeCount, producers, nodes.GetCommandBudget());
+
+    std::atomic<int> running = producers;
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back(
+            [&, producer]
+            {
+                const size_t count = nodeCount / producers;
+                std::vector<uint32_t> handles(count);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const ImVec2 pos{static_cast<float>(i % 1000) * 200.f, static_cast<float>(producer * (count / 1000 + 1) + i / 1000) * 150.f};
+
+                    handles[i] = queue.AddNode(desc, pos);
+
+                    if (0 != i)
+                        queue.AddConnection(handles[i - 1], 0, handles[i], 0);
+
+                    if (0 == i % 100 && 50 <= i)
+                        queue.RemoveNode(handles[i - 50]);
+                }
+
+                running--;
+            });
+    }
+
+    std::vector<double> times;
+    size_t applied = 0;
+    double applyTime = 0.0;
+
+    // a frame that applied nothing after the producers finished means the queue is drained
+    for (;;)
+    {
+        const bool finished = 0 == running;
+
+        times.push_back(RunFrame(nodes).milliseconds);
+        applied += nodes.GetStats().commands_;
+        applyTime = std::max(applyTime, nodes.GetStats().commands_time_);
+
+        if (finished && 0 == nodes.GetStats().commands_)
+            break;
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+
+    for (auto &thread : threads)
+        thread.join();
+
+    std::printf("    %10s %10s %10s %10s %10s %12s %12s\n", "frames", "p50 ms", "p99 ms", "max ms", "apply ms", "commands", "nodes");
+    std::printf(
+        "    %10zu %10.3f %10.3f %10.3f %10.3f %12zu %12zu\n",
+        times.size(),
+        Percentile(times, 0.50),
+        Percentile(times, 0.99),
+        *std::max_element(times.begin(), times.end()),
+        applyTime,
+        applied,
+        nodes.GetNodes().size());
+    std::printf(
+        "    %.0f commands/s, peak memory %.1f MiB\n",
+        applied / std::chrono::duration<double>(stop - start).count(),
+        GetPeakMemory() / (1024.0 * 1024.0));
+}
+
+// Tiles a grid that is never built as editor nodes and pans across it, only tiles near the view are loaded
+bool RunPaged(size_t nodeCount, int frames)
+{
+    const char *path = "bench.pages";
+
+    {
+        ImGui::ImGuiNodesSnapshotData data;
+        BenchmarkGraph::MakeSnapshot(data, nodeCount);
+
+        auto buildStart = std::chrono::steady_clock::now();
+        bool built = ImGui::ImGuiNodesPager::Build(path, data.GetSections());
+        auto buildStop = std::chrono::steady_clock::now();
+
+        if (!built)
+        {
+            std::printf("[-] Failed to write page file %s\n", path);
+            return false;
+        }
+
+        std::printf(
+            "\n[+] paged %zu nodes, page file written in %.2f ms\n",
+            nodeCount,
+            std::chrono::duration<double, std::milli>(buildStop - buildStart).count());
+    }
+
+    ImGui::ImGuiNodes nodes;
+    BenchmarkGraph::RegisterNodeDesc(nodes);
+
+    ImGui::ImGuiNodesPager pager;
+
+    if (!pager.Open(nodes, path))
+    {
+        std::printf("[-] Failed to open page file %s\n", path);
+        std::remove(path);
+        return false;
+    }
+
+    std::printf("    %-10s %10s %10s %10s %10s %10s %10s %10s\n", "scene", "p50 ms", "p90 ms", "max ms", "paging", "tiles", "nodes", "loads");
+
+    const BenchmarkScene scenes[] = {
+        {"pan", {0.f, 0.f}, 1.0f, {-240.f, -120.f}, 1.0f},
+        {"overview", {0.f, 0.f}, 0.3f, {-240.f, -120.f}, 1.0f},
+    };
+
+    for (const auto &scene : scenes)
+    {
+        nodes.SetScale(scene.scale);
+        nodes.SetScroll(scene.scroll);
+
+        std::vector<double> times;
+        times.reserve(frames);
+
+        double paging = 0.0;
+        size_t loads = pager.GetLoads();
+        size_t residentNodes = 0;
+
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            ImVec2 scroll = nodes.GetScroll();
+            nodes.SetScroll({scroll.x + scene.scrollPerFrame.x, scroll.y + scene.scrollPerFrame.y});
+
+            times.push_back(RunFrame(nodes).milliseconds);
+            paging = std::max(paging, nodes.GetStats().paging_time_);
+            residentNodes = std::max(residentNodes, pager.GetResidentNodes());
+        }
+
+        double maximum = *std::max_element(times.begin(), times.end());
+
+        std::printf(
+            "    %-10s %10.3f %10.3f %10.3f %10.3f %10zu %10zu %10zu\n",
+            scene.name,
+            Percentile(times, 0.50),
+            Percentile(times, 0.90),
+            maximum,
+            paging,
+            pager.GetResidentTiles(),
+            residentNodes,
+            pager.GetLoads() - loads);
+    }
+
+    std::printf("    %llu tiles, peak memory %.1f MiB\n", static_cast<unsigned long long>(pager.GetTileCount()), GetPeakMemory() / (1024.0 * 1024.0));
+
+    pager.Close();
+    std::remove(path);
+
+    return true;
+}
+
+// Lays out the same random tree with every ObjectRelationLayout mode, the extent is the canvas the tree covers
+// objects have node like sizes, fixed lays them out in slots of the largest size and sized by their own
+// flat is sized through a parent index array into one position buffer
+// tidy/1 is the tidy mode on one thread, tidy uses all cores
+// update adds leaves one at a time to the sized tidy layout and lays out only what changed
+void RunLayout(size_t maxNodes)
+{
+    std::printf("\n[+] tree layout\n");
+    std::printf("    %10s %-6s %-6s %10s %14s %14s\n", "nodes", "mode", "sizes", "ms", "width", "height");
+
+    const ImVec2 minSize{120.f, 30.f}, maxSize{360.f, 120.f};
+    const size_t edits = 1000;
+
+    const struct
+    {
+        const char *name;
+        ObjectRelationLayout::Mode mode;
+        int threads;
+    } modes[] = {
+        {"rows", ObjectRelationLayout::Mode::Rows, 0},
+        {"tidy/1", ObjectRelationLayout::Mode::Tidy, 1},
+        {"tidy", ObjectRelationLayout::Mode::Tidy, 0},
+    };
+
+    const struct
+    {
+        const char *name;
+        bool sized;
+        bool flat;
+    } variants[] = {
+        {"fixed", false, false},
+        {"sized", true, false},
+        {"flat", true, true},
+    };
+
+    for (size_t nodeCount = 1000; nodeCount <= maxNodes; nodeCount *= 10)
+    {
+        // Random recursive tree, every object hangs below a uniformly picked earlier one
+        std::vector<ObjectRelationLayout::ObjectInfoProxy> objects(nodeCount + edits);
+        std::vector<uint32_t> parents(nodeCount, UINT32_MAX);
+        std::vector<ImVec2> positions(nodeCount);
+        std::mt19937 random(1);
+
+        for (size_t i = 1; i < nodeCount; ++i)
+        {
+            parents[i] = random() % i;
+            objects[parents[i]].childrens.push_back(&objects[i]);
+        }
+
+        std::vector<ImVec2> sizes(nodeCount);
+
+        for (auto &size : sizes)
+        {
+            size.x = minSize.x + static_cast<float>(random() % static_cast<uint32_t>(maxSize.x - minSize.x));
+            size.y = minSize.y + static_cast<float>(random() % static_cast<uint32_t>(maxSize.y - minSize.y));
+        }
+
+        for (const auto &mode : modes)
+        {
+            for (const auto &variant : variants)
+            {
+                const bool flat = variant.flat;
+
+                for (size_t i = 0; i < nodeCount; ++i)
+                    objects[i].size = variant.sized ? sizes[i] : ImVec2{};
+
+                ObjectRelationLayout layout({0.f, 0.f}, maxSize, {100.f, 20.f});
+                layout.SetMode(mode.mode);
+                layout.SetThreads(mode.threads);
+
+                auto start = std::chrono::steady_clock::now();
+
+                if (flat)
+                    layout.MakeLayout(parents, positions, sizes);
+                else
+                    layout.MakeLayout(&objects[0]);
+
+                auto stop = std::chrono::steady_clock::now();
+
+                ImVec2 min = flat ? positions[0] : objects[0].position, max = min;
+
+                for (size_t i = 0; i < nodeCount; ++i)
+                {
+                    const auto &position = flat ? positions[i] : objects[i].position;
+
+                    min = ImVec2{std::min(min.x, position.x), std::min(min.y, position.y)};
+                    max = ImVec2{std::max(max.x, position.x + sizes[i].x), std::max(max.y, position.y + sizes[i].y)};
+                }
+
+                std::printf(
+                    "    %10zu %-6s %-6s %10.2f %14.0f %14.0f\n",
+                    nodeCount,
+                    mode.name,
+                    variant.name,
+                    std::chrono::duration<double, std::milli>(stop - start).count(),
+                    max.x - min.x,
+                    max.y - min.y);
+            }
+        }
+
+        ObjectRelationLayout layout({0.f, 0.f}, maxSize, {100.f, 20.f});
+        layout.SetMode(ObjectRelationLayout::Mode::Tidy);
+        layout.MakeLayout(&objects[0]);
+
+        size_t placed = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (size_t i = nodeCount; i < nodeCount + edits; ++i)
+        {
+            auto &parent = objects[random() % i];
+
+            objects[i].size = sizes[random() % nodeCount];
+            parent.childrens.push_back(&objects[i]);
+
+            layout.Invalidate(&parent);
+            layout.UpdateLayout();
+
+            placed += layout.GetPlacedCount();
+        }
+
+        auto stop = std::chrono::steady_clock::now();
+
+        std::printf(
+            "    %10zu %-6s %-6s %10.4f %14s %.1f objects placed per added leaf\n",
+            nodeCount,
+            "tidy",
+            "update",
+            std::chrono::duration<double, std::milli>(stop - start).count() / edits,
+            "",
+            static_cast<double>(placed) / edits);
+    }
+}
+
+// Steps the force directed layout with a 16 ms budget for a second of frames, starting from the layered result
+void RunForceLayout(ImGui::ImGuiNodes &nodes)
+{
+    ImGui::ImGuiNodesForceLayout layout;
+    layout.Start(nodes);
+
+    std::vector<double> times;
+
+    for (int frame = 0; frame < 60 && layout.IsRunning(); ++frame)
+    {
+        auto start = std::chrono::steady_clock::now();
+        layout.Step(nodes, 16.0);
+        auto stop = std::chrono::steady_clock::now();
+
+        times.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+    }
+
+    layout.Stop(nodes);
+
+    std::printf(
+        "    %10s force %d iterations in %zu frames, p50 %.2f ms, max %.2f ms\n",
+        "",
+        layout.GetIteration(),
+        times.size(),
+        Percentile(times, 0.50),
+        *std::max_element(times.begin(), times.end()));
+}
+
+// Random dataflow graph, every node reads both inputs from nodes shortly before it so paths share nodes
+// in many diamonds, a few links point backwards and close cycles
+void RunLayeredLayout(size_t maxNodes)
+{
+    std::printf("\n[+] layered layout\n");
+    std::printf("    %10s %10s %10s %10s %10s %12s\n", "nodes", "ms", "layers", "dummies", "reversed", "crossings");
+
+    for (size_t nodeCount = 1000; nodeCount <= maxNodes; nodeCount *= 10)
+    {
+        ImGui::ImGuiNodes nodes;
+        BenchmarkGraph::RegisterNodeDesc(nodes);
+
+        ImGui::ImGuiNodesNodeDesc *desc = nodes.FindNodeDesc("Benchmark");
+        std::mt19937 random(1);
+
+        ImGui::ImGuiNodesBatch batch;
+        batch.Reserve(nodeCount, nodeCount * 2);
+
+        for (size_t i = 0; i < nodeCount; ++i)
+            batch.AddNode(desc, ImVec2{static_cast<float>(random() % 100000), static_cast<float>(random() % 100000)});
+
+        for (uint32_t i = 1; i < nodeCount; ++i)
+        {
+            const uint32_t window = std::min(i, 64u);
+
+            batch.AddEdge(i - 1 - random() % window, 0, i, 0);
+
+            if (random() % 100 == 0 && i + 1 < nodeCount)
+                batch.AddEdge(std::min<uint32_t>(static_cast<uint32_t>(nodeCount) - 1, i + 1 + random() % 64), 1, i, 1);
+            else
+                batch.AddEdge(i - 1 - random() % window, 1, i, 1);
+        }
+
+        nodes.AddBatch(std::move(batch));
+
+        ImGui::NewFrame();
+        nodes.FlushBatches();
+        ImGui::EndFrame();
+
+        ImGui::ImGuiNodesLayeredLayout layout;
+
+        auto start = std::chrono::steady_clock::now();
+        layout.Apply(nodes);
+        auto stop = std::chrono::steady_clock::now();
+
+        std::printf(
+            "    %10zu %10.2f %10u %10u %10u %12zu\n",
+            nodeCount,
+            std::chrono::duration<double, std::milli>(stop - start).count(),
+            layout.GetLayerCount(),
+            layout.GetDummyCount(),
+            layout.GetReversedCount(),
+            layout.GetCrossingCount());
+
+        RunForceLayout(nodes);
+    }
+}
+
+// The ring only keeps the most recent events, enough for the last few thousand frames
+void DumpTrace(const char *path)
+{
+#if !defined(IMGUI_NODES_ENABLE_TRACE)
+    std::printf("\n[-] Trace scopes are compiled out, configure with -DIMGUI_NODES_ENABLE_TRACE=ON\n");
+#endif
+
+    const auto &trace = ImGui::ImGuiNodesTrace::Get();
+
+    if (trace.Dump(path))
+        std::printf("\n[+] %zu trace events written to %s\n", trace.GetEventCount(), path);
+    else
+        std::printf("\n[-] Failed to write trace %s\n", path);
+}
+
+// Replays a recording made by the test program with --record, the tag holds the grid node count
+bool RunReplay(const char *path)
+{
+    ImGui::ImGuiNodesRecorder recorder;
+
+    if (!recorder.Load(path))
+    {
+        std::printf("[-] Failed to load recording %s\n", path);
+        return false;
+    }
+
+    ImGui::ImGuiNodes nodes;
+    BenchmarkGraph::RegisterNodeDesc(nodes);
+
+    ImGui::GetIO().DisplaySize = recorder.display_size_;
+
+    ImGui::NewFrame();
+    BenchmarkGraph::MakeGraph(nodes, static_cast<size_t>(recorder.tag_));
+    ImGui::EndFrame();
+
+    std::printf("\n[+] replay %s, %zu frames against %llu nodes\n", path, recorder.GetFrameCount(), static_cast<unsigned long long>(recorder.tag_));
+    std::printf("    %8s %10s %10s %10s %10s %10s %10s %10s\n", "frame", "total ms", "canvas", "hit test", "state", "draw", "vertices", "indices");
+
+    std::vector<double> times;
+    size_t slowestFrame = 0;
+
+    while (recorder.Replay())
+    {
+        FrameSample sample = RunFrame(nodes);
+        const auto &stats = nodes.GetStats();
+
+        if (times.empty() || sample.milliseconds > times[slowestFrame])
+            slowestFrame = times.size();
+
+        std::printf(
+            "    %8zu %10.3f %10.3f %10.3f %10.3f %10.3f %10d %10d\n",
+            times.size(),
+            sample.milliseconds,
+            stats.canvas_geometry_time_,
+            stats.nodes_from_canvas_time_,
+            stats.state_machine_time_,
+            stats.process_nodes_time_,
+            sample.vertices,
+            sample.indices);
+
+        times.push_back(sample.milliseconds);
+    }
+
+    if (times.empty())
+        return true;
+
+    const double slowest = times[slowestFrame];
+
+    std::printf(
+        "    p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms at frame %zu\n",
+        Percentile(times, 0.50),
+        Percentile(times, 0.90),
+        Percentile(times, 0.99),
+        slowest,
+        slowestFrame);
+
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = 120;
+    size_t maxNodes = 1000000;
+    const char *replayPath = nullptr;
+    const char *tracePath = nullptr;
+    const char *importPath = nullptr;
+    size_t pagedNodes = 0;
+    size_t ingestNodes = 0;
+    bool layout = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (0 == std::strcmp(argv[i], "--frames") && i + 1 < argc)
+            frames = std::max(1, std::atoi(argv[++i]));
+        else if (0 == std::strcmp(argv[i], "--max-nodes") && i + 1 < argc)
+            maxNodes = std::strtoull(argv[++i], nullptr, 10);
+        else if (0 == std::strcmp(argv[i], "--replay") && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (0 == std::strcmp(argv[i], "--trace") && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (0 == std::strcmp(argv[i], "--import") && i + 1 < argc)
+            importPath = argv[++i];
+        else if (0 == std::strcmp(argv[i], "--paged") && i + 1 < argc)
+            pagedNodes = std::strtoull(argv[++i], nullptr, 10);
+        else if (0 == std::strcmp(argv[i], "--ingest") && i + 1 < argc)
+            ingestNodes = std::strtoull(argv[++i], nullptr, 10);
+        else if (0 == std::strcmp(argv[i], "--layout"))
+            layout = true;
+        else
+        {
+            std::printf("usage: %s [--frames N] [--max-nodes N] [--replay FILE] [--import FILE] [--paged N] [--ingest N] [--layout] [--trace FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    InitializeImGui();
+
+    bool succeed = true;
+    bool allocationFree = true;
+
+    if (replayPath)
+        succeed = RunReplay(replayPath);
+    else if (importPath)
+        succeed = RunImport(importPath);
+    else if (pagedNodes)
+        succeed = RunPaged(pagedNodes, frames);
+    else if (ingestNodes)
+        RunIngest(ingestNodes, 4);
+    else if (layout)
+    {
+        RunLayout(maxNodes);
+        RunLayeredLayout(maxNodes);
+    }
+    else
+        for (size_t nodeCount = 1000; nodeCount <= maxNodes; nodeCount *= 10)
+            allocationFree &= RunBenchmark(nodeCount, frames);
+
+    ImGui::DestroyContext();
+
+    if (tracePath)
+        DumpTrace(tracePath);
+
+    if (!succeed)
+        return 1;
+
+    if (!allocationFree)
+    {
+        std::printf("\n[-] The editor allocated on the heap in steady state frames\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <includes/BenchmarkGraph.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace BenchmarkGraph
+{
+    void RegisterNodeDesc(ImGui::ImGuiNodes &nodes)
+    {
+        nodes.AddNodeDesc(
+            {
+                .name_ = "Benchmark",
+                .type_ = ImGui::ImGuiNodesNodeType_Generic,
+                .color_ = ImColor(0.2f, 0.3f, 0.6f, 0.0f),
+                .inputs_ = {
+                    {"Left", ImGui::ImGuiNodesConnectorType_Float},
+                    {"Top", ImGui::ImGuiNodesConnectorType_Float},
+                },
+                .outputs_ = {
+                    {"Right", ImGui::ImGuiNodesConnectorType_Float},
+                    {"Bottom", ImGui::ImGuiNodesConnectorType_Float},
+                },
+            });
+    }
+
+    void MakeGraph(ImGui::ImGuiNodes &nodes, size_t count)
+    {
+        const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+
+        ImGui::ImGuiNodesNodeDesc *desc = nodes.FindNodeDesc("Benchmark");
+
+        ImGui::ImGuiNodesBatch batch;
+        batch.Reserve(count, count * 2);
+
+        for (size_t i = 0; i < count; ++i)
+            batch.AddNode(desc, ImVec2{static_cast<float>(i % columns) * 260.f, static_cast<float>(i / columns) * 160.f});
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint32_t node = static_cast<uint32_t>(i);
+
+            if (i % columns != 0)
+                batch.AddEdge(node - 1, 0, node, 0);
+
+            if (i >= columns)
+                batch.AddEdge(node - static_cast<uint32_t>(columns), 1, node, 1);
+        }
+
+        nodes.AddBatch(std::move(batch));
+    }
+
+    void MakeSnapshot(ImGui::ImGuiNodesSnapshotData &data, size_t count)
+    {
+        const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+
+        data = {};
+
+        ImGui::ImGuiNodesSnapshotDesc &desc = data.descs_.emplace_back();
+        std::strcpy(desc.name_, "Benchmark");
+        desc.type_ = ImGui::ImGuiNodesNodeType_Generic;
+        desc.color_ = ImVec4(0.2f, 0.3f, 0.6f, 0.0f);
+        desc.input_count_ = 2;
+        desc.output_count_ = 2;
+
+        data.connectors_ = {
+            {"Left", ImGui::ImGuiNodesConnectorType_Float},
+            {"Top", ImGui::ImGuiNodesConnectorType_Float},
+            {"Right", ImGui::ImGuiNodesConnectorType_Float},
+            {"Bottom", ImGui::ImGuiNodesConnectorType_Float},
+        };
+
+        data.nodes_.resize(count);
+        data.edges_.reserve(count * 2);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto &node = data.nodes_[i];
+            node.pos_ = ImVec2{static_cast<float>(i % columns) * 260.f, static_cast<float>(i / columns) * 160.f};
+            node.desc_ = 0;
+            node.state_ = 0;
+            node.name_ = 0;
+            node.id_ = static_cast<uint32_t>(i + 1);
+
+            const uint32_t index = static_cast<uint32_t>(i);
+
+            if (i % columns != 0)
+                data.edges_.push_back({index - 1, 0, index, 0});
+
+            if (i >= columns)
+                data.edges_.push_back({index - static_cast<uint32_t>(columns), 1, index, 1});
+        }
+    }
+
+    void ShowWindow(ImGui::ImGuiNodes &nodes)
+    {
+        ImGui::SetNextWindowPos({}, ImGuiCond_Always);
+        ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize, ImGuiCond_Always);
+
+        ImGui::Begin("Nodes", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings);
+        nodes.Update();
+        nodes.ProcessNodes();
+        nodes.ProcessContextMenu();
+        ImGui::End();
+    }
+}
@@ -1,5 +1,53 @@
 #include <includes/ObjectRelationLayout.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+// subtrees smaller than this are never split between workers
+constexpr size_t ObjectRelationTaskGrain = 4096;
+
+// Tasks are dealt round robin, so every worker starts on its own share of the largest ones, drains its own
+// queue and then steals from the queues of the others
+template <typename Fn>
+static void RunTasks(size_t tasks, int threads, Fn &&fn)
+{
+    struct alignas(64) Queue
+    {
+        std::atomic<size_t> head = 0;
+    };
+
+    std::vector<Queue> queues(threads);
+
+    const auto work = [&](int worker)
+    {
+        for (int victim = 0; victim < threads; ++victim)
+        {
+            const int queue = (worker + victim) % threads;
+
+            for (;;)
+            {
+                const size_t task = queue + queues[queue].head.fetch_add(1, std::memory_order_relaxed) * threads;
+
+                if (task >= tasks)
+                    break;
+
+                fn(worker, task);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (int i = 1; i < threads; ++i)
+        workers.emplace_back(work, i);
+
+    work(0);
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
 ObjectRelationLayout::ObjectRelationLayout(ImVec2 rootPosition, ImVec2 objectSize, ImVec2 objectSpacing)
     : m_rootPosition(rootPosition),
       m_objectSize(objectSize),
@@ -7,73 +55,924 @@ ObjectRelationLayout::ObjectRelationLayout(ImVec2 rootPosition, ImVec2 objectSiz
 {
 }
 
-void ObjectRelationLayout::CalculateLevelGroups(ObjectInfoProxy *root, size_t depth)
+ImVec2 ObjectRelationLayout::GetObjectSize(const void *object) const
+{
+    if (nullptr == m_binding.getSize)
+        return m_objectSize;
+
+    const ImVec2 size = m_binding.getSize(m_binding.access, object);
+
+    if (0.f >= size.x || 0.f >= size.y)
+        return m_objectSize;
+
+    return size;
+}
+
+const std::vector<const void *> &ObjectRelationLayout::GatherChildrens(const void *object)
+{
+    m_childrens.clear();
+    m_binding.gatherChildrens(m_binding.access, object, m_childrens);
+
+    return m_childrens;
+}
+
+void ObjectRelationLayout::FitColumn(size_t depth, float width)
+{
+    if (m_columns.size() <= depth)
+        m_columns.resize(depth + 1, 0.f);
+
+    m_columns[depth] = std::max(m_columns[depth], width);
+}
+
+bool ObjectRelationLayout::CalculateColumns()
 {
-    if (0 == depth)
-        m_levelGroupInfo.push_back({});
+    bool moved = m_columnX.size() != m_columns.size();
+    float x = m_rootPosition.x;
+
+    m_columnX.resize(m_columns.size());
 
-    if (!root->childrens.empty())
+    for (size_t i = 0; i < m_columns.size(); ++i)
     {
-        if (m_levelGroupInfo.size() < depth + 2)
-            m_levelGroupInfo.push_back({depth + 1});
+        moved |= m_columnX[i] != x;
 
-        m_levelGroupInfo[depth + 1].groupsCount++;
-        m_levelGroupInfo[depth + 1].groupParents.push_back(root);
+        m_columnX[i] = x;
+        x += m_columns[i] + m_objectSpacing.x;
     }
 
-    for (auto &child : root->childrens)
-        CalculateLevelGroups(child, depth + 1);
+    return moved;
 }
 
-void ObjectRelationLayout::CalculateDefaultLayout(ObjectInfoProxy *root, size_t depth)
+void ObjectRelationLayout::CalculateDefaultLayout(const void *root)
 {
-    static float currentY = 0;
+    m_stack.clear();
+    m_rows.clear();
+    m_columns.clear();
 
-    if (0 == depth)
+    m_stack.push_back({root, None, 0, 0});
+
+    while (!m_stack.empty())
     {
-        root->position = m_rootPosition;
-        currentY = m_rootPosition.y;
+        const Visit visit = m_stack.back();
+        m_stack.pop_back();
+
+        const auto index = static_cast<uint32_t>(m_rows.size());
+        const ImVec2 size = GetObjectSize(visit.object);
+        float y = m_currentY;
+
+        if (0 == visit.depth)
+        {
+            y = m_rootPosition.y;
+            m_currentY = m_rootPosition.y;
+        }
+        else
+            m_currentY += size.y + m_objectSpacing.y;
+
+        FitColumn(visit.depth, size.x);
+
+        if (None != visit.parent && visit.number == m_rows[visit.parent].childCount / 2)
+            m_rows[visit.parent].middleChild = index;
+
+        const auto &childrens = GatherChildrens(visit.object);
+
+        m_rows.push_back({visit.object, visit.depth, static_cast<uint32_t>(childrens.size()), None, y, size.y});
+
+        // Reversed so the first child is popped first, the same order the recursive walk had
+        for (size_t i = childrens.size(); i != 0; --i)
+            m_stack.push_back({childrens[i - 1], index, static_cast<uint32_t>(i - 1), visit.depth + 1});
     }
-    else
+
+    CalculateColumns();
+}
+
+void ObjectRelationLayout::CalculateLevelGroups()
+{
+    m_levelGroupInfo.push_back({0, 0, 0, None, 0.f});
+
+    for (const auto &row : m_rows)
+    {
+        if (0 == row.childCount)
+            continue;
+
+        if (m_levelGroupInfo.size() < row.depth + 2)
+            m_levelGroupInfo.push_back({row.depth + 1, 0, 0, None, 0.f});
+
+        m_levelGroupInfo[row.depth + 1].groupsCount++;
+    }
+
+    // Only the middle parent of a level is needed, a second pass finds it instead of listing all of them
+    for (size_t i = 0; i < m_rows.size(); ++i)
+    {
+        const auto &row = m_rows[i];
+
+        if (0 == row.childCount)
+            continue;
+
+        auto &info = m_levelGroupInfo[row.depth + 1];
+
+        if (info.visited++ == info.groupsCount / 2)
+            info.middleParent = static_cast<uint32_t>(i);
+    }
+}
+
+void ObjectRelationLayout::CalculateCenterLayout()
+{
+    for (size_t i = 1; i < m_levelGroupInfo.size(); ++i)
+    {
+        auto &info = m_levelGroupInfo[i];
+
+        const auto &parentRow = m_rows[info.middleParent];
+        const auto &childRow = m_rows[parentRow.middleChild];
+
+        // Centers are lined up, objects of different heights would drift apart by their tops
+        info.deltaY = parentRow.y + parentRow.height * 0.5f;
+        info.deltaY -= childRow.y + childRow.height * 0.5f;
+        info.deltaY += m_levelGroupInfo[i - 1].deltaY;
+    }
+
+    for (const auto &row : m_rows)
+    {
+        const float deltaY = 0 != row.depth ? m_levelGroupInfo[row.depth].deltaY : 0.f;
+
+        SetPosition(row.object, {m_columnX[row.depth], row.y + deltaY});
+    }
+
+    m_placedCount = m_rows.size();
+}
+
+void ObjectRelationLayout::AppendChildren(uint32_t object)
+{
+    const auto objectInfo = m_tidyNodes[object].object;
+    const ImVec2 size = GetObjectSize(objectInfo);
+    const uint32_t depth = m_tidyNodes[object].depth;
+    const auto &childrens = GatherChildrens(objectInfo);
+
+    m_tidyNodes[object].height = size.y;
+    FitColumn(depth, size.x);
+
+    m_tidyNodes[object].firstChild = static_cast<uint32_t>(m_tidyNodes.size());
+    m_tidyNodes[object].childCount = static_cast<uint32_t>(childrens.size());
+
+    for (size_t n = 0; n < childrens.size(); ++n)
+    {
+        const auto index = static_cast<uint32_t>(m_tidyNodes.size());
+        m_tidyNodes.push_back({.object = childrens[n], .parent = object, .number = static_cast<uint32_t>(n), .ancestor = index, .depth = depth + 1});
+    }
+}
+
+void ObjectRelationLayout::FlattenTree(const void *root)
+{
+    m_tidyNodes.clear();
+    m_tidyIndex.clear();
+    m_records.clear();
+    m_columns.clear();
+    m_deadCount = 0;
+    m_liveRecords = 0;
+
+    m_tidyNodes.push_back({.object = root});
+
+    for (size_t i = 0; i < m_tidyNodes.size(); ++i)
+        AppendChildren(static_cast<uint32_t>(i));
+}
+
+void ObjectRelationLayout::MoveSubtree(uint32_t left, uint32_t right, double shift)
+{
+    auto &wm = m_tidyNodes[left];
+    auto &wp = m_tidyNodes[right];
+
+    const double subtrees = wp.number - wm.number;
+
+    wp.change -= shift / subtrees;
+    wp.shift += shift;
+    wm.change += shift / subtrees;
+    wp.prelim += shift;
+    wp.mod += shift;
+}
+
+void ObjectRelationLayout::ExecuteShifts(uint32_t object)
+{
+    const auto &node = m_tidyNodes[object];
+
+    double shift = 0.0;
+    double change = 0.0;
+
+    for (uint32_t i = node.childCount; i != 0; --i)
+    {
+        auto &child = m_tidyNodes[node.firstChild + i - 1];
+
+        child.prelim += shift;
+        child.mod += shift;
+        change += child.change;
+        shift += child.shift + change;
+    }
+}
+
+double ObjectRelationLayout::GetSeparation(uint32_t left, uint32_t right) const
+{
+    return (m_tidyNodes[left].height + m_tidyNodes[right].height) * 0.5 + m_objectSpacing.y;
+}
+
+uint32_t ObjectRelationLayout::Apportion(uint32_t object, uint32_t defaultAncestor, std::vector<TidyRecord> &records)
+{
+    const auto &node = m_tidyNodes[object];
+
+    if (0 == node.number)
+        return defaultAncestor;
+
+    // Inner and outer contours of the right subtree (plus) and of its left siblings (minus)
+    uint32_t vip = object;
+    uint32_t vop = object;
+    uint32_t vim = object - 1;
+    uint32_t vom = m_tidyNodes[node.parent].firstChild;
+
+    double sip = m_tidyNodes[vip].mod;
+    double sop = m_tidyNodes[vop].mod;
+    double sim = m_tidyNodes[vim].mod;
+    double som = m_tidyNodes[vom].mod;
+
+    uint32_t nextRight = m_tidyNodes[vim].NextRight();
+    uint32_t nextLeft = m_tidyNodes[vip].NextLeft();
+
+    while (None != nextRight && None != nextLeft)
+    {
+        vim = nextRight;
+        vip = nextLeft;
+        vom = m_tidyNodes[vom].NextLeft();
+        vop = m_tidyNodes[vop].NextRight();
+
+        Record(records, vop);
+        m_tidyNodes[vop].ancestor = object;
+
+        const double shift = (m_tidyNodes[vim].prelim + sim) - (m_tidyNodes[vip].prelim + sip) + GetSeparation(vim, vip);
+
+        if (shift > 0.0)
+        {
+            // The ancestor is only meaningful when it is a sibling of the object being placed
+            const uint32_t ancestor = m_tidyNodes[vim].ancestor;
+            const bool sibling = m_tidyNodes[ancestor].parent == node.parent;
+
+            MoveSubtree(sibling ? ancestor : defaultAncestor, object, shift);
+
+            sip += shift;
+            sop += shift;
+        }
+
+        sim += m_tidyNodes[vim].mod;
+        sip += m_tidyNodes[vip].mod;
+        som += m_tidyNodes[vom].mod;
+        sop += m_tidyNodes[vop].mod;
+
+        nextRight = m_tidyNodes[vim].NextRight();
+        nextLeft = m_tidyNodes[vip].NextLeft();
+    }
+
+    if (None != nextRight && None == m_tidyNodes[vop].NextRight())
     {
-        root->position.x = depth * m_objectSize.x + depth * m_objectSpacing.x;
-        root->position.y = currentY;
+        Record(records, vop);
+        m_tidyNodes[vop].thread = nextRight;
+        m_tidyNodes[vop].mod += sim - sop;
+    }
 
-        currentY += m_objectSize.y + m_objectSpacing.y;
+    if (None != nextLeft && None == m_tidyNodes[vom].NextLeft())
+    {
+        Record(records, vom);
+        m_tidyNodes[vom].thread = nextLeft;
+        m_tidyNodes[vom].mod += sip - som;
+        defaultAncestor = object;
     }
 
-    for (auto &child : root->childrens)
-        CalculateDefaultLayout(child, depth + 1);
+    return defaultAncestor;
+}
+
+void ObjectRelationLayout::Record(std::vector<TidyRecord> &records, uint32_t object) const
+{
+    const auto &node = m_tidyNodes[object];
+
+    records.push_back({object, node.thread, node.ancestor, node.mod});
 }
 
-void ObjectRelationLayout::CalculateCenterLayout(ObjectInfoProxy *root, size_t depth)
+void ObjectRelationLayout::Combine(uint32_t object, std::vector<TidyRecord> &records)
 {
-    if (0 == depth)
+    auto &node = m_tidyNodes[object];
+
+    const auto firstRecord = records.size();
+    double midpoint = 0.0;
+
+    if (0 != node.childCount)
     {
-        for (size_t i = 1; i < m_levelGroupInfo.size(); ++i)
+        uint32_t defaultAncestor = node.firstChild;
+
+        for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child)
         {
-            auto &info = m_levelGroupInfo[i];
+            auto &childNode = m_tidyNodes[child];
+
+            if (child != node.firstChild)
+            {
+                childNode.prelim = m_tidyNodes[child - 1].prelim + GetSeparation(child - 1, child);
 
-            auto parentNode = info.groupParents[info.groupsCount / 2];
-            auto childNode = parentNode->childrens[parentNode->childrens.size() / 2];
+                if (childNode.childCount)
+                    childNode.mod = childNode.prelim - childNode.midpoint;
+            }
 
-            info.deltaY = parentNode->position.y - childNode->position.y;
-            info.deltaY += m_levelGroupInfo[i - 1].deltaY;
+            defaultAncestor = Apportion(child, defaultAncestor, records);
         }
+
+        ExecuteShifts(object);
+
+        midpoint = (m_tidyNodes[node.firstChild].prelim + m_tidyNodes[node.firstChild + node.childCount - 1].prelim) * 0.5;
+    }
+
+    node.prelim = midpoint;
+    node.midpoint = midpoint;
+    node.firstRecord = static_cast<uint32_t>(firstRecord);
+    node.recordCount = static_cast<uint32_t>(records.size() - firstRecord);
+}
+
+void ObjectRelationLayout::Uncombine(uint32_t object)
+{
+    auto &node = m_tidyNodes[object];
+
+    for (uint32_t i = node.recordCount; i != 0; --i)
+    {
+        const auto &record = m_records[node.firstRecord + i - 1];
+        auto &target = m_tidyNodes[record.object];
+
+        target.thread = record.thread;
+        target.ancestor = record.ancestor;
+        target.mod = record.mod;
+    }
+
+    m_liveRecords -= node.recordCount;
+    node.recordCount = 0;
+
+    // The childrens go back to how their own subtrees left them
+    for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child)
+    {
+        auto &childNode = m_tidyNodes[child];
+
+        childNode.prelim = childNode.midpoint;
+        childNode.mod = 0.0;
+        childNode.shift = 0.0;
+        childNode.change = 0.0;
+        childNode.ancestor = child;
+    }
+}
+
+void ObjectRelationLayout::RemoveSubtree(uint32_t object)
+{
+    m_tidyStack.clear();
+    m_tidyStack.push_back(object);
+
+    while (!m_tidyStack.empty())
+    {
+        auto &node = m_tidyNodes[m_tidyStack.back()];
+        m_tidyStack.pop_back();
+
+        for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child)
+            m_tidyStack.push_back(child);
+
+        m_tidyIndex.erase(node.object);
+        m_liveRecords -= node.recordCount;
+
+        node.object = nullptr;
+        node.recordCount = 0;
+        ++m_deadCount;
+    }
+}
+
+void ObjectRelationLayout::ReplaceChildren(uint32_t object)
+{
+    const auto objectInfo = m_tidyNodes[object].object;
+    const ImVec2 size = GetObjectSize(objectInfo);
+    const uint32_t depth = m_tidyNodes[object].depth;
+    const auto &childrens = GatherChildrens(objectInfo);
+
+    m_tidyNodes[object].height = size.y;
+    FitColumn(depth, size.x);
+
+    // Kept childrens move along into the new range, their own childrens stay where they are
+    const auto first = static_cast<uint32_t>(m_tidyNodes.size());
+
+    for (size_t n = 0; n < childrens.size(); ++n)
+    {
+        const auto index = static_cast<uint32_t>(m_tidyNodes.size());
+        const auto found = m_tidyIndex.find(childrens[n]);
+
+        if (m_tidyIndex.end() != found && m_tidyNodes[found->second].parent == object)
+        {
+            TidyNode moved = m_tidyNodes[found->second];
+
+            moved.number = static_cast<uint32_t>(n);
+            moved.ancestor = index;
+
+            m_tidyNodes[found->second].object = nullptr;
+            m_tidyNodes[found->second].recordCount = 0;
+            ++m_deadCount;
+
+            m_tidyNodes.push_back(moved);
+            found->second = index;
+
+            for (uint32_t child = moved.firstChild; child < moved.firstChild + moved.childCount; ++child)
+                m_tidyNodes[child].parent = index;
+        }
+        else
+        {
+            m_tidyNodes.push_back({.object = childrens[n], .parent = object, .number = static_cast<uint32_t>(n), .ancestor = index, .depth = depth + 1});
+            m_tidyStack.push_back(index);
+        }
+    }
+
+    m_tidyNodes[object].firstChild = first;
+    m_tidyNodes[object].childCount = static_cast<uint32_t>(childrens.size());
+}
+
+void ObjectRelationLayout::CompactRecords()
+{
+    if (m_records.size() <= m_liveRecords * 2 + m_tidyNodes.size())
+        return;
+
+    std::vector<TidyRecord> records;
+    records.reserve(m_liveRecords);
+
+    for (auto &node : m_tidyNodes)
+    {
+        if (nullptr == node.object || 0 == node.recordCount)
+            continue;
+
+        const auto firstRecord = static_cast<uint32_t>(records.size());
+
+        records.insert(records.end(), m_records.begin() + node.firstRecord, m_records.begin() + node.firstRecord + node.recordCount);
+        node.firstRecord = firstRecord;
+    }
+
+    m_records.swap(records);
+}
+
+void ObjectRelationLayout::PlaceNode(const TidyNode &node, std::vector<uint32_t> &stack, bool all)
+{
+    SetPosition(node.object, {m_columnX[node.depth], m_rootPosition.y + static_cast<float>(node.center - m_tidyOrigin - node.height * 0.5)});
+
+    const double shift = node.shift + node.mod;
+
+    for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child)
+    {
+        auto &childNode = m_tidyNodes[child];
+        const double center = childNode.prelim + shift;
+
+        if (!all && !childNode.dirty && center == childNode.center)
+            continue;
+
+        childNode.shift = shift;
+        childNode.center = center;
+
+        stack.push_back(child);
+    }
+}
+
+size_t ObjectRelationLayout::PlaceSubtree(uint32_t object, std::vector<uint32_t> &stack, bool all)
+{
+    size_t placed = 0;
+
+    stack.clear();
+    stack.push_back(object);
+
+    // Second walk, an object that stays put keeps its whole subtree in place unless it was laid out again
+    while (!stack.empty())
+    {
+        const auto &node = m_tidyNodes[stack.back()];
+        stack.pop_back();
+
+        PlaceNode(node, stack, all);
+        ++placed;
+    }
+
+    return placed;
+}
+
+void ObjectRelationLayout::PlaceTidyNodes(bool all)
+{
+    m_tidyNodes[0].shift = 0.0;
+    m_tidyNodes[0].center = m_tidyNodes[0].prelim;
+
+    m_placedCount = PlaceSubtree(0, m_tidyStack, all);
+}
+
+int ObjectRelationLayout::GetTidyThreads() const
+{
+    if (0 < m_threads)
+        return m_threads;
+
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+void ObjectRelationLayout::PartitionTidyNodes(size_t cutoff)
+{
+    m_upperNodes.clear();
+    m_taskRoots.clear();
+    m_tasks.clear();
+
+    // Breadth first, every parent comes before its children
+    m_subtreeSizes.assign(m_tidyNodes.size(), 1);
+
+    for (size_t i = m_tidyNodes.size() - 1; i != 0; --i)
+        m_subtreeSizes[m_tidyNodes[i].parent] += m_subtreeSizes[i];
+
+    if (m_subtreeSizes[0] <= cutoff)
+        return;
+
+    // Subtrees up to the cutoff become tasks, small neighbours are batched until they reach it together
+    TidyTask task = {0, 0, 0};
+
+    m_upperNodes.push_back(0);
+
+    for (size_t i = 0; i < m_upperNodes.size(); ++i)
+    {
+        const auto &node = m_tidyNodes[m_upperNodes[i]];
+
+        for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child)
+        {
+            if (m_subtreeSizes[child] > cutoff)
+            {
+                m_upperNodes.push_back(child);
+                continue;
+            }
+
+            m_taskRoots.push_back(child);
+            task.weight += m_subtreeSizes[child];
+
+            if (task.weight >= cutoff)
+            {
+                task.rootCount = static_cast<uint32_t>(m_taskRoots.size()) - task.firstRoot;
+                m_tasks.push_back(task);
+
+                task = {static_cast<uint32_t>(m_taskRoots.size()), 0, 0};
+            }
+        }
+    }
+
+    if (0 != task.weight)
+    {
+        task.rootCount = static_cast<uint32_t>(m_taskRoots.size()) - task.firstRoot;
+        m_tasks.push_back(task);
+    }
+
+    std::sort(
+        m_tasks.begin(),
+        m_tasks.end(),
+        [](const TidyTask &left, const TidyTask &right)
+        {
+            return left.weight > right.weight;
+        });
+}
+
+void ObjectRelationLayout::CombineTask(const TidyTask &task, TidyWorker &worker)
+{
+    for (uint32_t i = task.firstRoot; i < task.firstRoot + task.rootCount; ++i)
+    {
+        worker.nodes.clear();
+        worker.nodes.push_back(m_taskRoots[i]);
+
+        for (size_t n = 0; n < worker.nodes.size(); ++n)
+        {
+            const auto &node = m_tidyNodes[worker.nodes[n]];
+
+            for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child)
+                worker.nodes.push_back(child);
+        }
+
+        for (size_t n = worker.nodes.size(); n != 0; --n)
+        {
+            const uint32_t object = worker.nodes[n - 1];
+
+            Combine(object, worker.records);
+
+            if (0 != m_tidyNodes[object].recordCount)
+                worker.recorded.push_back(object);
+        }
+    }
+}
+
+void ObjectRelationLayout::CalculateTidyLayout(const void *root, bool keepOrigin)
+{
+    FlattenTree(root);
+
+    const int threads = GetTidyThreads();
+
+    m_tasks.clear();
+
+    if (1 < threads)
+        PartitionTidyNodes(std::max(ObjectRelationTaskGrain, m_tidyNodes.size() / (threads * 8)));
+
+    if (m_tasks.empty())
+    {
+        // First walk, children are done before their parents
+        for (size_t i = m_tidyNodes.size(); i != 0; --i)
+            Combine(static_cast<uint32_t>(i - 1), m_records);
     }
     else
-        root->position.y += m_levelGroupInfo[depth].deltaY;
+    {
+        m_tidyWorkers.resize(threads);
+
+        for (auto &worker : m_tidyWorkers)
+        {
+            worker.records.clear();
+            worker.recorded.clear();
+        }
+
+        RunTasks(
+            m_tasks.size(),
+            threads,
+            [this](int worker, size_t task)
+            {
+                CombineTask(m_tasks[task], m_tidyWorkers[worker]);
+            });
+
+        // The records of the workers are moved behind each other, then the upper part merges the contours
+        for (auto &worker : m_tidyWorkers)
+        {
+            const auto base = static_cast<uint32_t>(m_records.size());
+
+            m_records.insert(m_records.end(), worker.records.begin(), worker.records.end());
 
-    for (auto &child : root->childrens)
-        CalculateCenterLayout(child, depth + 1);
+            for (auto object : worker.recorded)
+                m_tidyNodes[object].firstRecord += base;
+        }
+
+        for (size_t i = m_upperNodes.size(); i != 0; --i)
+            Combine(m_upperNodes[i - 1], m_records);
+    }
+
+    m_liveRecords = m_records.size();
+
+    if (!keepOrigin)
+        m_tidyOrigin = m_tidyNodes[0].prelim - m_tidyNodes[0].height * 0.5;
+
+    CalculateColumns();
+
+    if (m_tasks.empty())
+    {
+        PlaceTidyNodes(true);
+        return;
+    }
+
+    // The upper part goes first and hands the shifts down to the task roots
+    m_tidyNodes[0].shift = 0.0;
+    m_tidyNodes[0].center = m_tidyNodes[0].prelim;
+
+    for (auto object : m_upperNodes)
+        PlaceNode(m_tidyNodes[object], m_tidyStack, true);
+
+    RunTasks(
+        m_tasks.size(),
+        threads,
+        [this](int worker, size_t task)
+        {
+            const auto &tidyTask = m_tasks[task];
+
+            for (uint32_t i = tidyTask.firstRoot; i < tidyTask.firstRoot + tidyTask.rootCount; ++i)
+                PlaceSubtree(m_taskRoots[i], m_tidyWorkers[worker].nodes, true);
+        });
+
+    m_placedCount = m_tidyNodes.size();
 }
 
-void ObjectRelationLayout::MakeLayout(ObjectInfoProxy *root)
+void ObjectRelationLayout::LayoutTree(const void *root)
 {
+    m_root = root;
+    m_invalid.clear();
+
+    if (Mode::Tidy == m_mode)
+    {
+        CalculateTidyLayout(root, false);
+        return;
+    }
+
+    m_tidyNodes.clear();
     m_levelGroupInfo.clear();
 
     CalculateDefaultLayout(root);
 
-    CalculateLevelGroups(root);
-    CalculateCenterLayout(root);
-}
\ No newline at end of file
+    CalculateLevelGroups();
+    CalculateCenterLayout();
+}
+
+void ObjectRelationLayout::MakeLayout(ObjectInfoProxy *root)
+{
+    ProxyAccess access;
+
+    MakeLayout(access, root);
+}
+
+void ObjectRelationLayout::MakeLayout(const FlatTree &tree, uint32_t root, std::span<ImVec2> positions)
+{
+    FlatAccess access = {tree, positions.data()};
+
+    MakeLayout(access, &positions[root]);
+}
+
+void ObjectRelationLayout::MakeLayout(std::span<const uint32_t> parents, std::span<ImVec2> positions, std::span<const ImVec2> sizes)
+{
+    if (parents.empty())
+        return;
+
+    uint32_t root = 0;
+
+    // Counting sort by parent, the childrens of every object end up in one range ordered by their index
+    m_flatOffsets.assign(parents.size() + 1, 0);
+
+    for (uint32_t i = 0; i < parents.size(); ++i)
+    {
+        if (parents[i] < parents.size())
+            m_flatOffsets[parents[i] + 1]++;
+        else
+            root = i;
+    }
+
+    for (size_t i = 1; i < m_flatOffsets.size(); ++i)
+        m_flatOffsets[i] += m_flatOffsets[i - 1];
+
+    m_flatChildren.resize(m_flatOffsets.back());
+
+    for (uint32_t i = 0; i < parents.size(); ++i)
+    {
+        if (parents[i] < parents.size())
+            m_flatChildren[m_flatOffsets[parents[i]]++] = i;
+    }
+
+    // Filling moved every offset to the end of its range
+    for (size_t i = m_flatOffsets.size() - 1; i != 0; --i)
+        m_flatOffsets[i] = m_flatOffsets[i - 1];
+
+    m_flatOffsets[0] = 0;
+
+    MakeLayout({m_flatOffsets, m_flatChildren, sizes}, root, positions);
+}
+
+void ObjectRelationLayout::Invalidate(const void *object)
+{
+    m_invalid.push_back(object);
+}
+
+void ObjectRelationLayout::UpdateLayout()
+{
+    ProxyAccess access;
+
+    UpdateLayout(access);
+}
+
+void ObjectRelationLayout::UpdateLayout(const FlatTree &tree, std::span<ImVec2> positions)
+{
+    FlatAccess access = {tree, positions.data()};
+
+    UpdateLayout(access);
+}
+
+void ObjectRelationLayout::UpdateTree()
+{
+    if (nullptr == m_root)
+        return;
+
+    if (Mode::Tidy != m_mode || m_tidyNodes.empty())
+    {
+        LayoutTree(m_root);
+        return;
+    }
+
+    // Once most of the nodes are left over from earlier updates it is cheaper to start over in place
+    if (m_deadCount > m_tidyNodes.size() - m_deadCount)
+    {
+        m_invalid.clear();
+        CalculateTidyLayout(m_root, true);
+        return;
+    }
+
+    m_placedCount = 0;
+
+    if (m_invalid.empty())
+        return;
+
+    if (m_tidyIndex.empty())
+    {
+        for (size_t i = 0; i < m_tidyNodes.size(); ++i)
+            if (nullptr != m_tidyNodes[i].object)
+                m_tidyIndex.emplace(m_tidyNodes[i].object, static_cast<uint32_t>(i));
+    }
+
+    const auto byDepth = [this](uint32_t left, uint32_t right)
+    {
+        return m_tidyNodes[left].depth < m_tidyNodes[right].depth;
+    };
+
+    const auto markPaths = [this]()
+    {
+        for (auto object : m_invalid)
+        {
+            const auto found = m_tidyIndex.find(object);
+
+            if (m_tidyIndex.end() == found)
+                continue;
+
+            for (uint32_t node = found->second; None != node && !m_tidyNodes[node].dirty; node = m_tidyNodes[node].parent)
+            {
+                m_tidyNodes[node].dirty = true;
+                m_dirty.push_back(node);
+            }
+        }
+    };
+
+    // Take back the placement of the invalidated objects and their ancestors, ancestors first as what an
+    // object recorded was written after everything below it
+    m_changed.clear();
+    m_dirty.clear();
+
+    for (auto object : m_invalid)
+    {
+        const auto found = m_tidyIndex.find(object);
+
+        if (m_tidyIndex.end() != found)
+            m_changed.push_back(found->second);
+    }
+
+    std::sort(m_changed.begin(), m_changed.end());
+    m_changed.erase(std::unique(m_changed.begin(), m_changed.end()), m_changed.end());
+
+    markPaths();
+    std::sort(m_dirty.begin(), m_dirty.end(), byDepth);
+
+    for (auto node : m_dirty)
+    {
+        Uncombine(node);
+        m_tidyNodes[node].dirty = false;
+    }
+
+    m_dirty.clear();
+
+    // All removals go first so an object moved to another parent is seen as new there
+    for (auto node : m_changed)
+    {
+        if (nullptr == m_tidyNodes[node].object)
+            continue;
+
+        for (auto child : GatherChildrens(m_tidyNodes[node].object))
+        {
+            const auto found = m_tidyIndex.find(child);
+
+            if (m_tidyIndex.end() != found && m_tidyNodes[found->second].parent == node)
+                m_tidyNodes[found->second].kept = true;
+        }
+
+        const uint32_t firstChild = m_tidyNodes[node].firstChild;
+        const uint32_t childCount = m_tidyNodes[node].childCount;
+
+        for (uint32_t child = firstChild; child < firstChild + childCount; ++child)
+        {
+            if (m_tidyNodes[child].kept)
+                m_tidyNodes[child].kept = false;
+            else if (nullptr != m_tidyNodes[child].object)
+                RemoveSubtree(child);
+        }
+    }
+
+    // Deepest first, an object is done before its parent moves it into a new range
+    std::sort(m_changed.begin(), m_changed.end(), byDepth);
+    m_tidyStack.clear();
+
+    for (size_t i = m_changed.size(); i != 0; --i)
+        if (nullptr != m_tidyNodes[m_changed[i - 1]].object)
+            ReplaceChildren(m_changed[i - 1]);
+
+    // New subtrees are flattened breadth first behind everything else
+    for (size_t i = 0; i < m_tidyStack.size(); ++i)
+    {
+        const uint32_t node = m_tidyStack[i];
+        const auto firstChild = static_cast<uint32_t>(m_tidyNodes.size());
+
+        m_tidyIndex[m_tidyNodes[node].object] = node;
+        m_tidyNodes[node].dirty = true;
+        m_dirty.push_back(node);
+
+        AppendChildren(node);
+
+        for (auto child = firstChild; child < m_tidyNodes.size(); ++child)
+            m_tidyStack.push_back(child);
+    }
+
+    markPaths();
+    std::sort(m_dirty.begin(), m_dirty.end(), byDepth);
+
+    for (size_t i = m_dirty.size(); i != 0; --i)
+    {
+        Combine(m_dirty[i - 1], m_records);
+        m_liveRecords += m_tidyNodes[m_dirty[i - 1]].recordCount;
+    }
+
+    // Columns only grow between full layouts, a wider one moves everything to its right
+    PlaceTidyNodes(CalculateColumns());
+
+    for (auto node : m_dirty)
+        m_tidyNodes[node].dirty = false;
+
+    m_invalid.clear();
+    m_dirty.clear();
+
+    CompactRecords();
+}
@@ -1,15 +1,18 @@
 #include <modules/ImGuiNodes.h>
+#include <modules/ImGuiNodesRecorder.h>
 #include <includes/ObjectRelationLayout.h>
+#include <includes/BenchmarkGraph.h>
 
 #include <imgui/imgui.h>
 #include <imgui/backends/imgui_impl_glfw.h>
 #include <imgui/backends/imgui_impl_opengl3.h>
 #include <GLFW/glfw3.h>
 
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
-#include <unordered_map>
 
 #define WINDOW_WIDTH 1600
 #define WINDOW_HEIGHT 900
@@ -18,16 +21,26 @@ struct DemoObject
 {
     std::string name;
     std::vector<DemoObject *> childrens;
+
+    ImGui::ImGuiNodesNode *node = nullptr;
 };
 
-struct ObjectProxy : ObjectRelationLayout::ObjectInfoProxy
+// Lays the demo objects out where they are, by the size their nodes really have
+struct DemoObjectAccess
 {
-    DemoObject *object;
-    ImGui::ImGuiNodesNode *node;
+    using Object = DemoObject;
+
+    const std::vector<DemoObject *> &GetChildrens(DemoObject *object) { return object->childrens; }
+    ImVec2 GetSize(DemoObject *object) { return object->node->area_node_.GetSize(); }
+    void SetPosition(DemoObject *object, ImVec2 position) { object->node->MoveNode(position); }
 };
 
 std::vector<DemoObject> g_objects;
-std::vector<ObjectProxy> g_objectProxies;
+
+// --record FILE [--nodes N] captures input against the benchmark graph for bench --replay
+ImGui::ImGuiNodesRecorder g_recorder;
+const char *g_recordPath = nullptr;
+size_t g_recordNodes = 1000;
 
 void MakeDemoObjectsData()
 {
@@ -81,27 +94,6 @@ void MakeDemoObjectsData()
     g_objects[19].childrens.push_back(&g_objects[18]);
 }
 
-void MakeObjectProxiesData()
-{
-    std::unordered_map<DemoObject *, ObjectProxy *> objectProxyRelationMapping;
-
-    g_objectProxies.resize(g_objects.size());
-    for (size_t i = 0; i < g_objects.size(); ++i)
-    {
-        auto currentObject = &g_objects[i];
-        auto currentObjectProxy = &g_objectProxies[i];
-
-        currentObjectProxy->object = currentObject;
-        objectProxyRelationMapping.emplace(currentObject, currentObjectProxy);
-    }
-
-    for (auto &objectProxy : g_objectProxies)
-    {
-        for (auto objectChild : objectProxy.object->childrens)
-            objectProxy.childrens.push_back(objectProxyRelationMapping.at(objectChild));
-    }
-}
-
 void RegisterObjectRelationNodeDesc(ImGui::ImGuiNodes &nodes)
 {
     nodes.AddNodeDesc(
@@ -127,38 +119,50 @@ void RegisterObjectRelationNodeDesc(ImGui::ImGuiNodes &nodes)
 void MakeLayout()
 {
     static ObjectRelationLayout layout;
+    DemoObjectAccess access;
 
-    layout.MakeLayout(&g_objectProxies[0]);
+    layout.MakeLayout(access, &g_objects[0]);
 }
 
 void AddNodes(ImGui::ImGuiNodes &nodes)
 {
-    for (auto &objectProxy : g_objectProxies)
+    for (auto &object : g_objects)
     {
         auto node = nodes.AddNode("RelationShip");
 
-        node->user_data_ = objectProxy.object;
-        node->SetName(objectProxy.object->name.data());
+        node->user_data_ = &object;
+        node->SetName(object.name.data());
         node->ToggleCollapse();
-        node->MoveNode(objectProxy.position);
 
-        objectProxy.node = node;
+        object.node = node;
     }
 }
 
 void AddConnections(ImGui::ImGuiNodes &nodes)
 {
-    for (auto &objectProxy : g_objectProxies)
+    for (auto &object : g_objects)
     {
-        auto parentNode = objectProxy.node;
+        for (auto child : object.childrens)
+            nodes.AddConnection(object.node, child->node);
+    }
+}
 
-        for (auto child : objectProxy.childrens)
-        {
-            auto childNode = static_cast<ObjectProxy *>(child)->node;
+void RenderRecording()
+{
+    static ImGui::ImGuiNodes nodes;
+    static bool initialized = false;
 
-            nodes.AddConnection(parentNode, childNode);
-        }
+    if (!initialized)
+    {
+        BenchmarkGraph::RegisterNodeDesc(nodes);
+        BenchmarkGraph::MakeGraph(nodes, g_recordNodes);
+
+        g_recorder.tag_ = g_recordNodes;
+
+        initialized = true;
     }
+
+    BenchmarkGraph::ShowWindow(nodes);
 }
 
 void Render()
@@ -169,14 +173,16 @@ void Render()
     if (!initialized)
     {
         MakeDemoObjectsData();
-        MakeObjectProxiesData();
 
         RegisterObjectRelationNodeDesc(nodes);
 
-        MakeLayout();
-
         AddNodes(nodes);
+        MakeLayout();
         AddConnections(nodes);
+        // building the demo graph is not something to undo
+        nodes.ClearUndo();
+
+        nodes.SetStatsOverlay(true);
 
         initialized = true;
     }
@@ -191,8 +197,21 @@ void Render()
     ImGui::End();
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    for (int i = 1; i < argc; ++i)
+    {
+        if (0 == std::strcmp(argv[i], "--record") && i + 1 < argc)
+            g_recordPath = argv[++i];
+        else if (0 == std::strcmp(argv[i], "--nodes") && i + 1 < argc)
+            g_recordNodes = std::strtoull(argv[++i], nullptr, 10);
+        else
+        {
+            std::cout << "[-] Usage: " << argv[0] << " [--record FILE [--nodes N]]" << std::endl;
+            return 1;
+        }
+    }
+
     // Initialize glfw
     glfwSetErrorCallback(
         [](int error, const char *description)
@@ -231,12 +250,17 @@ int main()
 
         imguiIO.IniFilename = nullptr;
 
-        ImFontConfig fontConfig;
-        fontConfig.SizePixels = 22.f;
-        imguiIO.Fonts->AddFontDefault(&fontConfig);
+        // Recordings keep the default font and style so the headless replay lays nodes out identically
+        if (nullptr == g_recordPath)
+        {
+            ImFontConfig fontConfig;
+            fontConfig.SizePixels = 22.f;
+            imguiIO.Fonts->AddFontDefault(&fontConfig);
+
+            ImGui::GetStyle().ScaleAllSizes(3.f);
+        }
 
         ImGui::StyleColorsDark();
-        ImGui::GetStyle().ScaleAllSizes(3.f);
     }
 
     if (!ImGui_ImplGlfw_InitForOpenGL(window, true))
@@ -269,7 +293,13 @@ int main()
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
-        Render();
+        if (g_recordPath)
+        {
+            g_recorder.Record();
+            RenderRecording();
+        }
+        else
+            Render();
 
         // Rendering
         ImGui::Render();
@@ -278,6 +308,14 @@ int main()
         glfwSwapBuffers(window);
     }
 
+    if (g_recordPath)
+    {
+        if (g_recorder.Save(g_recordPath))
+            std::cout << "[+] Recorded " << g_recorder.GetFrameCount() << " frames to " << g_recordPath << std::endl;
+        else
+            std::cout << "[-] Failed to save recording " << g_recordPath << std::endl;
+    }
+
     // Cleanup
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -0,0 +1,78 @@
+#include "Tests.h"
+
+#include <modules/ImGuiNodesExecutor.h>
+#include <includes/BenchmarkGraph.h>
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace
+{
+    void SetConstantKernel(ImGui::ImGuiNodesExecutor &executor)
+    {
+        executor.SetKernel("Benchmark", [](ImGui::ImGuiNodesExecutionContext &context) -> ImGui::ImGuiNodesTask
+                           {
+                               for (ImGui::ImGuiNodesValue &output : context.outputs_)
+                                   output.Set<float>(1.f);
+                               co_return; });
+    }
+
+    void Run(ImGui::ImGuiNodesExecutor &executor, ImGui::ImGuiNodes &nodes, ImGui::ImGuiNodesNode *node)
+    {
+        executor.Execute(nodes, node);
+
+        while (executor.IsRunning())
+        {
+            executor.Commit(nodes);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+TEST(RemovedNodeOutputIsNotInherited)
+{
+    ImGui::ImGuiNodes nodes;
+    BenchmarkGraph::RegisterNodeDesc(nodes);
+
+    ImGui::ImGuiNodesExecutor executor;
+    SetConstantKernel(executor);
+
+    ImGui::ImGuiNodesNode *node = nodes.AddNode("Benchmark");
+    Run(executor, nodes, node);
+    CHECK(executor.GetOutput(node, 0) != nullptr);
+
+    nodes.RemoveNode(node);
+    delete node;
+
+    // a new node may well take the freed address, it has not run yet
+    ImGui::ImGuiNodesNode *added = nodes.AddNode("Benchmark");
+    CHECK(executor.GetOutput(added, 0) == nullptr);
+
+    executor.Commit(nodes);
+    CHECK(executor.GetOutput(added, 0) == nullptr);
+}
+
+TEST(LoadedGraphOutputIsNotInherited)
+{
+    const char *path = "unit_tests_executor.snap";
+
+    ImGui::ImGuiNodes nodes;
+    BenchmarkGraph::RegisterNodeDesc(nodes);
+    BenchmarkGraph::MakeGraph(nodes, 4);
+    nodes.FlushBatches();
+
+    CHECK(nodes.SaveSnapshot(path));
+
+    ImGui::ImGuiNodesExecutor executor;
+    SetConstantKernel(executor);
+    Run(executor, nodes, nullptr);
+    CHECK(executor.GetOutput(nodes.GetNodes().front(), 0) != nullptr);
+
+    // the loaded nodes keep the saved ids, which the executor has results for
+    CHECK(nodes.LoadSnapshot(path));
+    for (const ImGui::ImGuiNodesNode *node : nodes.GetNodes())
+        CHECK(executor.GetOutput(node, 0) == nullptr);
+
+    std::remove(path);
+}
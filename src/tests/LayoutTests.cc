@@ -0,0 +1,52 @@
+#include "Tests.h"
+
+#include <modules/ImGuiNodesLayout.h>
+#include <includes/BenchmarkGraph.h>
+
+#include <cstdio>
+
+TEST(ForceLayoutIgnoresMovesOfFreedNodes)
+{
+    ImGui::ImGuiNodes nodes;
+    BenchmarkGraph::RegisterNodeDesc(nodes);
+    BenchmarkGraph::MakeGraph(nodes, 16);
+    nodes.FlushBatches();
+
+    ImGui::ImGuiNodesForceLayout layout;
+    layout.Start(nodes);
+    CHECK(layout.Step(nodes, 0.0)); // one iteration
+
+    ImGui::ImGuiNodesNode *node = nodes.GetNodes().back();
+    nodes.RemoveNode(node);
+    delete node;
+
+    // may take the freed address, the layout has not moved it
+    ImGui::ImGuiNodesNode *added = nodes.AddNode("Benchmark", ImVec2(-5000.0f, -5000.0f));
+    const ImVec2 center = added->area_node_.GetCenter();
+
+    layout.Stop(nodes);
+    CHECK(added->area_node_.GetCenter().x == center.x && added->area_node_.GetCenter().y == center.y);
+}
+
+TEST(ForceLayoutDropsMovesOfLoadedGraph)
+{
+    const char *path = "unit_tests_layout.snap";
+
+    ImGui::ImGuiNodes nodes;
+    BenchmarkGraph::RegisterNodeDesc(nodes);
+    BenchmarkGraph::MakeGraph(nodes, 16);
+    nodes.FlushBatches();
+
+    CHECK(nodes.SaveSnapshot(path));
+
+    ImGui::ImGuiNodesForceLayout layout;
+    layout.Start(nodes);
+    CHECK(layout.Step(nodes, 0.0));
+
+    // the loaded nodes likely reuse the freed addresses, none of them were moved by the layout
+    CHECK(nodes.LoadSnapshot(path));
+    layout.Stop(nodes);
+    CHECK(!nodes.CanUndo());
+
+    std::remove(path);
+}
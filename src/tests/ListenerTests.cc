@@ -0,0 +1,62 @@
+#include "Tests.h"
+
+#include <includes/BenchmarkGraph.h>
+
+#include <cstdio>
+
+namespace
+{
+    struct ResetCounter : ImGui::ImGuiNodesListener
+    {
+        int resets = 0;
+        size_t reset_nodes = 0; // graph size seen by the last reset
+
+        void OnReset(const ImGui::ImGuiNodes &nodes) override
+        {
+            ++resets;
+            reset_nodes = nodes.GetNodes().size();
+        }
+    };
+}
+
+TEST(LoadSnapshotResetsListenerOnce)
+{
+    const char *path = "unit_tests_listener.snap";
+
+    ResetCounter listener;
+    ImGui::ImGuiNodes nodes;
+    BenchmarkGraph::RegisterNodeDesc(nodes);
+    BenchmarkGraph::MakeGraph(nodes, 16);
+    nodes.FlushBatches();
+
+    CHECK(nodes.SaveSnapshot(path));
+
+    nodes.SetListener(&listener);
+    CHECK(nodes.LoadSnapshot(path));
+    CHECK(listener.resets == 1);
+    CHECK(listener.reset_nodes == 16);
+
+    nodes.SetListener(nullptr);
+    std::remove(path);
+}
+
+TEST(ImportJsonResetsListenerOnce)
+{
+    const char *path = "unit_tests_listener.json";
+
+    ResetCounter listener;
+    ImGui::ImGuiNodes nodes;
+    BenchmarkGraph::RegisterNodeDesc(nodes);
+    BenchmarkGraph::MakeGraph(nodes, 16);
+    nodes.FlushBatches();
+
+    CHECK(nodes.ExportJson(path));
+
+    nodes.SetListener(&listener);
+    CHECK(nodes.ImportJson(path));
+    CHECK(listener.resets == 1);
+    CHECK(listener.reset_nodes == 16);
+
+    nodes.SetListener(nullptr);
+    std::remove(path);
+}
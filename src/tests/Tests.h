@@ -0,0 +1,48 @@
+#ifndef TESTS_H // !TESTS_H
+#define TESTS_H
+
+#include <modules/ImGuiNodes.h>
+
+#include <cstdio>
+#include <vector>
+
+// Headless checks of the editor modules, every TEST runs once from main() inside an imgui frame
+namespace Tests
+{
+    typedef void (*TestFunction)();
+
+    struct TestCase
+    {
+        const char *name;
+        TestFunction function;
+    };
+
+    std::vector<TestCase> &GetTests();
+
+    struct Registrar
+    {
+        Registrar(const char *name, TestFunction function) { GetTests().push_back({name, function}); }
+    };
+
+    extern int g_failures;
+
+    // Ends the frame the test runs in and starts the next one, batches and commands apply in the update
+    void RunFrame(ImGui::ImGuiNodes &nodes);
+}
+
+#define TEST(name)                                                  \
+    static void name();                                             \
+    static Tests::Registrar name##Registrar(#name, name);           \
+    static void name()
+
+#define CHECK(condition)                                                                    \
+    do                                                                                      \
+    {                                                                                       \
+        if (!(condition))                                                                   \
+        {                                                                                   \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);       \
+            ++Tests::g_failures;                                                            \
+        }                                                                                   \
+    } while (0)
+
+#endif // !TESTS_H
@@ -0,0 +1,69 @@
+#include "Tests.h"
+
+#include <includes/BenchmarkGraph.h>
+
+#include <imgui/imgui.h>
+
+#include <cstdio>
+
+#define DISPLAY_WIDTH 1920
+#define DISPLAY_HEIGHT 1080
+
+namespace Tests
+{
+    int g_failures = 0;
+
+    std::vector<TestCase> &GetTests()
+    {
+        static std::vector<TestCase> tests;
+        return tests;
+    }
+
+    void RunFrame(ImGui::ImGuiNodes &nodes)
+    {
+        BenchmarkGraph::ShowWindow(nodes);
+        ImGui::Render();
+        ImGui::NewFrame();
+    }
+}
+
+void InitializeImGui()
+{
+    ImGui::CreateContext();
+
+    auto &imguiIO = ImGui::GetIO();
+
+    imguiIO.IniFilename = nullptr;
+    imguiIO.LogFilename = nullptr;
+    imguiIO.DisplaySize = ImVec2{static_cast<float>(DISPLAY_WIDTH), static_cast<float>(DISPLAY_HEIGHT)};
+    imguiIO.DeltaTime = 1.f / 60.f;
+
+    // Null renderer, nothing is drawn
+    imguiIO.BackendRendererName = "imgui_impl_null";
+    imguiIO.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+
+    unsigned char *pixels = nullptr;
+    int width = 0, height = 0;
+    imguiIO.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+}
+
+int main()
+{
+    InitializeImGui();
+
+    for (const Tests::TestCase &test : Tests::GetTests())
+    {
+        const int failures = Tests::g_failures;
+
+        ImGui::NewFrame();
+        test.function();
+        ImGui::EndFrame();
+
+        std::printf("%-48s %s\n", test.name, failures == Tests::g_failures ? "ok" : "FAILED");
+    }
+
+    ImGui::DestroyContext();
+
+    std::printf("%zu tests, %d failed checks\n", Tests::GetTests().size(), Tests::g_failures);
+    return Tests::g_failures ? 1 : 0;
+}